@@ -36,3 +36,34 @@ bool fromB64(const char *src, size_t srcLen, bool isUrl, uint8_t *dest, size_t *
 #ifdef __cplusplus
 }
 #endif // __cplusplus
+
+#ifdef __cplusplus
+
+#include "lightstd/span.h"
+#include "lightstd/string_view.h"
+
+// Encodes a byte range as hexadecimal text.
+inline bool toHex(lightstd::span<const uint8_t> src, char *dest, size_t *destLen)
+{
+    return toHex(src.data(), src.size(), dest, destLen);
+}
+
+// Decodes a hexadecimal text range into raw bytes.
+inline bool fromHex(lightstd::string_view src, uint8_t *dest, size_t *destLen)
+{
+    return fromHex(src.data(), src.length(), dest, destLen);
+}
+
+// Encodes a byte range as standard or URL-safe Base64 text.
+inline bool toB64(lightstd::span<const uint8_t> src, bool isUrl, char *dest, size_t *destLen)
+{
+    return toB64(src.data(), src.size(), isUrl, dest, destLen);
+}
+
+// Decodes a standard or URL-safe Base64 text range into raw bytes.
+inline bool fromB64(lightstd::string_view src, bool isUrl, uint8_t *dest, size_t *destLen)
+{
+    return fromB64(src.data(), src.length(), isUrl, dest, destLen);
+}
+
+#endif // __cplusplus
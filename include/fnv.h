@@ -17,3 +17,15 @@ uint32_t fnv1a32(const void *data, size_t len, uint32_t initialHash = FNV1A32_IN
 #ifdef __cplusplus
 }
 #endif // __cplusplus
+
+#ifdef __cplusplus
+
+#include "lightstd/span.h"
+
+// Computes a 32-bit FNV-1a hash for a byte range.
+inline uint32_t fnv1a32(lightstd::span<const uint8_t> data, uint32_t initialHash = FNV1A32_INITIAL_HASH)
+{
+    return fnv1a32(data.data(), data.size(), initialHash);
+}
+
+#endif // __cplusplus
@@ -0,0 +1,431 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "allocator.h"
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+namespace detail {
+
+// Bit operations shared by bitset and dynamic_bitset. Derived provides words(), word_count() and size(),
+// and must keep the unused bits of the last word cleared. Everything works a 32-bit word at a time, the
+// native width of the ESP32 cores.
+template <class Derived>
+class bitset_base
+{
+public:
+    static constexpr size_t npos = (size_t)-1;
+
+    // Reports whether the requested bit is set.
+    [[nodiscard]] bool test(size_t pos) const noexcept
+    {
+        assert(pos < self().size());
+        return (self().words()[pos / 32] >> (pos % 32)) & 1u;
+    }
+
+    // Reports whether the requested bit is set.
+    [[nodiscard]] bool operator[](size_t pos) const noexcept
+    {
+        return test(pos);
+    }
+
+    // Sets the requested bit to value.
+    void set(size_t pos, bool value = true) noexcept
+    {
+        assert(pos < self().size());
+        if (value) {
+            self().words()[pos / 32] |= 1u << (pos % 32);
+        }
+        else {
+            self().words()[pos / 32] &= ~(1u << (pos % 32));
+        }
+    }
+
+    // Clears the requested bit.
+    void reset(size_t pos) noexcept
+    {
+        set(pos, false);
+    }
+
+    // Toggles the requested bit.
+    void flip(size_t pos) noexcept
+    {
+        assert(pos < self().size());
+        self().words()[pos / 32] ^= 1u << (pos % 32);
+    }
+
+    // Sets every bit.
+    void set_all() noexcept
+    {
+        size_t n = self().word_count();
+
+        if (n > 0) {
+            memset(self().words(), 0xFF, n * sizeof(uint32_t));
+            clearTail();
+        }
+    }
+
+    // Clears every bit.
+    void reset_all() noexcept
+    {
+        size_t n = self().word_count();
+
+        if (n > 0) {
+            memset(self().words(), 0, n * sizeof(uint32_t));
+        }
+    }
+
+    // Returns the number of set bits.
+    [[nodiscard]] size_t count() const noexcept
+    {
+        const uint32_t *w = self().words();
+        size_t total = 0;
+
+        for (size_t i = 0; i < self().word_count(); i++) {
+            total += (size_t)__builtin_popcount(w[i]);
+        }
+        return total;
+    }
+
+    // Reports whether any bit is set.
+    [[nodiscard]] bool any() const noexcept
+    {
+        const uint32_t *w = self().words();
+
+        for (size_t i = 0; i < self().word_count(); i++) {
+            if (w[i] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Reports whether no bit is set.
+    [[nodiscard]] bool none() const noexcept
+    {
+        return !any();
+    }
+
+    // Reports whether every bit is set.
+    [[nodiscard]] bool all() const noexcept
+    {
+        return count() == self().size();
+    }
+
+    // Returns the index of the first set bit, or npos.
+    [[nodiscard]] size_t find_first() const noexcept
+    {
+        return scan(0, 0);
+    }
+
+    // Returns the index of the first set bit after pos, or npos.
+    [[nodiscard]] size_t find_next(size_t pos) const noexcept
+    {
+        return (pos < self().size()) ? scan(pos + 1, 0) : npos;
+    }
+
+    // Returns the index of the first clear bit, or npos. Handy to pick a free slot from an allocation map.
+    [[nodiscard]] size_t find_first_unset() const noexcept
+    {
+        return scan(0, UINT32_MAX);
+    }
+
+    // Returns the index of the first clear bit after pos, or npos.
+    [[nodiscard]] size_t find_next_unset(size_t pos) const noexcept
+    {
+        return (pos < self().size()) ? scan(pos + 1, UINT32_MAX) : npos;
+    }
+
+protected:
+    void clearTail() noexcept
+    {
+        size_t bits = self().size() % 32;
+
+        if (bits != 0) {
+            self().words()[self().word_count() - 1] &= (1u << bits) - 1;
+        }
+    }
+
+    template <class Other>
+    void andWith(const Other& other) noexcept
+    {
+        assert(other.size() == self().size());
+        for (size_t i = 0; i < self().word_count(); i++) {
+            self().words()[i] &= other.words()[i];
+        }
+    }
+
+    template <class Other>
+    void orWith(const Other& other) noexcept
+    {
+        assert(other.size() == self().size());
+        for (size_t i = 0; i < self().word_count(); i++) {
+            self().words()[i] |= other.words()[i];
+        }
+    }
+
+    template <class Other>
+    void xorWith(const Other& other) noexcept
+    {
+        assert(other.size() == self().size());
+        for (size_t i = 0; i < self().word_count(); i++) {
+            self().words()[i] ^= other.words()[i];
+        }
+    }
+
+private:
+    // Finds the first bit at or after pos that differs from invert, skipping whole words that cannot match.
+    size_t scan(size_t pos, uint32_t invert) const noexcept
+    {
+        const uint32_t *w = self().words();
+        const size_t bits = self().size();
+        size_t idx;
+        uint32_t word;
+
+        if (pos >= bits) {
+            return npos;
+        }
+        idx = pos / 32;
+        word = (w[idx] ^ invert) & (UINT32_MAX << (pos % 32));
+        for (;;) {
+            if (word != 0) {
+                pos = idx * 32 + (size_t)__builtin_ctz(word);
+                return (pos < bits) ? pos : npos;
+            }
+            if (++idx >= self().word_count()) {
+                return npos;
+            }
+            word = w[idx] ^ invert;
+        }
+    }
+
+    Derived& self() noexcept
+    {
+        return *static_cast<Derived*>(this);
+    }
+
+    const Derived& self() const noexcept
+    {
+        return *static_cast<const Derived*>(this);
+    }
+};
+
+} // namespace detail
+
+// Fixed-size set of N bits stored inline in 32-bit words.
+template <size_t N>
+class bitset : public detail::bitset_base<bitset<N>>
+{
+    static_assert(N > 0, "bitset: N must be greater than zero.");
+
+public:
+    // Creates a bitset with every bit cleared.
+    constexpr bitset() noexcept = default;
+
+    // Returns the number of bits.
+    [[nodiscard]] constexpr size_t size() const noexcept
+    {
+        return N;
+    }
+
+    // Returns the number of 32-bit words backing the bits.
+    [[nodiscard]] constexpr size_t word_count() const noexcept
+    {
+        return WORDS;
+    }
+
+    // Returns the backing words. Bit i lives in word i / 32 at position i % 32.
+    uint32_t* words() noexcept
+    {
+        return w;
+    }
+
+    // Returns the backing words.
+    const uint32_t* words() const noexcept
+    {
+        return w;
+    }
+
+    // Keeps only the bits also set in other.
+    bitset& operator&=(const bitset& other) noexcept
+    {
+        this->andWith(other);
+        return *this;
+    }
+
+    // Adds the bits set in other.
+    bitset& operator|=(const bitset& other) noexcept
+    {
+        this->orWith(other);
+        return *this;
+    }
+
+    // Toggles the bits set in other.
+    bitset& operator^=(const bitset& other) noexcept
+    {
+        this->xorWith(other);
+        return *this;
+    }
+
+    // Reports whether both bitsets hold the same bits.
+    bool operator==(const bitset& other) const noexcept
+    {
+        return memcmp(w, other.w, sizeof(w)) == 0;
+    }
+
+    // Reports whether the bitsets differ.
+    bool operator!=(const bitset& other) const noexcept
+    {
+        return !(*this == other);
+    }
+
+private:
+    static constexpr size_t WORDS = (N + 31) / 32;
+
+    uint32_t w[WORDS]{};
+};
+
+// Set of bits sized at runtime, allocated through an IAllocator.
+class dynamic_bitset : public detail::bitset_base<dynamic_bitset>
+{
+public:
+    // Creates an empty bitset using the provided allocator or the default one.
+    dynamic_bitset(IAllocator *_alloc = nullptr) noexcept
+    {
+        alloc = _alloc ? _alloc : IAllocator::getDefault();
+    }
+
+    dynamic_bitset(const dynamic_bitset&) = delete;
+    // Transfers ownership of the bits.
+    dynamic_bitset(dynamic_bitset&& other) noexcept : alloc(other.alloc), w(other.w), bits(other.bits)
+    {
+        other.w = nullptr;
+        other.bits = 0;
+    }
+
+    // Releases the bits.
+    ~dynamic_bitset() noexcept
+    {
+        release();
+    }
+
+    dynamic_bitset& operator=(const dynamic_bitset&) = delete;
+    dynamic_bitset& operator=(dynamic_bitset&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            alloc = other.alloc;
+            w = other.w;
+            bits = other.bits;
+            other.w = nullptr;
+            other.bits = 0;
+        }
+        return *this;
+    }
+
+    // Changes the number of bits. Existing bits are kept and new ones start cleared.
+    [[nodiscard]] bool resize(size_t newBits) noexcept
+    {
+        size_t oldWords = word_count();
+        size_t newWords = (newBits + 31) / 32;
+
+        if (newWords != oldWords) {
+            uint32_t *newW = nullptr;
+
+            if (newWords > 0) {
+                if (newWords > SIZE_MAX / sizeof(uint32_t)) {
+                    return false;
+                }
+                newW = static_cast<uint32_t*>(alloc->allocate(newWords * sizeof(uint32_t)));
+                if (!newW) {
+                    return false;
+                }
+                if (oldWords < newWords) {
+                    if (oldWords > 0) {
+                        memcpy(newW, w, oldWords * sizeof(uint32_t));
+                    }
+                    memset(newW + oldWords, 0, (newWords - oldWords) * sizeof(uint32_t));
+                }
+                else {
+                    memcpy(newW, w, newWords * sizeof(uint32_t));
+                }
+            }
+            release();
+            w = newW;
+        }
+        bits = newBits;
+        if (bits > 0) {
+            clearTail();
+        }
+        return true;
+    }
+
+    // Returns the number of bits.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return bits;
+    }
+
+    // Returns the number of 32-bit words backing the bits.
+    [[nodiscard]] size_t word_count() const noexcept
+    {
+        return (bits + 31) / 32;
+    }
+
+    // Returns the backing words. Bit i lives in word i / 32 at position i % 32.
+    uint32_t* words() noexcept
+    {
+        return w;
+    }
+
+    // Returns the backing words.
+    const uint32_t* words() const noexcept
+    {
+        return w;
+    }
+
+    // Keeps only the bits also set in other. Both bitsets must have the same size.
+    dynamic_bitset& operator&=(const dynamic_bitset& other) noexcept
+    {
+        andWith(other);
+        return *this;
+    }
+
+    // Adds the bits set in other. Both bitsets must have the same size.
+    dynamic_bitset& operator|=(const dynamic_bitset& other) noexcept
+    {
+        orWith(other);
+        return *this;
+    }
+
+    // Toggles the bits set in other. Both bitsets must have the same size.
+    dynamic_bitset& operator^=(const dynamic_bitset& other) noexcept
+    {
+        xorWith(other);
+        return *this;
+    }
+
+private:
+    void release() noexcept
+    {
+        if (w) {
+            alloc->deallocate(w);
+        }
+    }
+
+private:
+    IAllocator *alloc{nullptr};
+    uint32_t *w{nullptr};
+    size_t bits{0};
+};
+
+} // namespace lightstd
@@ -0,0 +1,230 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "allocator.h"
+#include "bitset.h"
+#include "fnv.h"
+#include "string_view.h"
+#include <esp_err.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Probabilistic set answering "was this key possibly added?" in a fixed number of bits. There are no false
+// negatives, and false positives happen at roughly the rate requested in init(). At 1% it costs about
+// 9.6 bits per expected key, against the 8+ bytes per entry of a hash map, which makes it a cheap pre-check
+// in front of an exact but more expensive lookup.
+// Each key is hashed once with FNV-1a. Two remixed values h1 and h2 derived from it select the k probed
+// bits as h1 + i * h2 (double hashing), so the cost does not grow with k.
+// NOTE: Keys cannot be removed. Call clear() to start over, e.g. when a dedup window rolls.
+// NOTE: bloom_filter is not thread-safe; guard shared filters with a Mutex.
+class bloom_filter
+{
+public:
+    static constexpr uint32_t MAX_HASHES = 16;
+
+    // Creates an empty filter using the provided allocator or the default one. Call init() before use.
+    bloom_filter(IAllocator *_alloc = nullptr) noexcept : bits(_alloc)
+    {
+    }
+
+    bloom_filter(const bloom_filter&) = delete;
+    bloom_filter(bloom_filter&&) noexcept = default;
+
+    bloom_filter& operator=(const bloom_filter&) = delete;
+    bloom_filter& operator=(bloom_filter&&) noexcept = default;
+
+    // Sizes the filter for the expected number of keys and the target false positive rate, which must be
+    // between 0 and 1 exclusive. Any keys added before are discarded.
+    esp_err_t init(size_t expectedItems, float falsePositiveRate = 0.01f) noexcept
+    {
+        double m;
+        size_t bitCount;
+        uint32_t k;
+
+        if (expectedItems < 1 || !(falsePositiveRate > 0.0f && falsePositiveRate < 1.0f)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        // Optimal sizes: m = -n * ln(p) / ln(2)^2 bits and k = m / n * ln(2) hashes.
+        m = -(double)expectedItems * std::log((double)falsePositiveRate) / (LN2 * LN2);
+        if (m > (double)(UINT32_MAX - 31)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        bitCount = ((size_t)std::ceil(m) + 31) & ~(size_t)31;
+        k = (uint32_t)std::lround((double)bitCount / (double)expectedItems * LN2);
+        if (k < 1) {
+            k = 1;
+        }
+        else if (k > MAX_HASHES) {
+            k = MAX_HASHES;
+        }
+
+        bits.reset_all();
+        if (!bits.resize(bitCount)) {
+            return ESP_ERR_NO_MEM;
+        }
+        hashes = k;
+
+        // Done
+        return ESP_OK;
+    }
+
+    // Releases the bits.
+    void deinit() noexcept
+    {
+        (void)bits.resize(0);
+        hashes = 0;
+    }
+
+    // Adds a key given as a byte range.
+    void add(const void *data, size_t len) noexcept
+    {
+        probe<true>(data, len);
+    }
+
+    // Adds a string key.
+    void add(string_view key) noexcept
+    {
+        probe<true>(key.data(), key.length());
+    }
+
+    // Adds an integer key, such as a message ID.
+    template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    void add(T key) noexcept
+    {
+        probe<true>(&key, sizeof(key));
+    }
+
+    // Reports whether a key given as a byte range may have been added. False means it never was.
+    [[nodiscard]] bool might_contain(const void *data, size_t len) const noexcept
+    {
+        return const_cast<bloom_filter*>(this)->probe<false>(data, len);
+    }
+
+    // Reports whether a string key may have been added.
+    [[nodiscard]] bool might_contain(string_view key) const noexcept
+    {
+        return might_contain(key.data(), key.length());
+    }
+
+    // Reports whether an integer key may have been added.
+    template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    [[nodiscard]] bool might_contain(T key) const noexcept
+    {
+        return might_contain(&key, sizeof(key));
+    }
+
+    // Adds a key and reports whether it may have been added before, hashing it only once. This is the
+    // usual "have we seen this packet" check.
+    bool test_and_add(const void *data, size_t len) noexcept
+    {
+        return probe<true>(data, len);
+    }
+
+    // Adds a string key and reports whether it may have been added before.
+    bool test_and_add(string_view key) noexcept
+    {
+        return probe<true>(key.data(), key.length());
+    }
+
+    // Adds an integer key and reports whether it may have been added before.
+    template <class T, std::enable_if_t<std::is_integral_v<T>, int> = 0>
+    bool test_and_add(T key) noexcept
+    {
+        return probe<true>(&key, sizeof(key));
+    }
+
+    // Forgets every key while keeping the allocation.
+    void clear() noexcept
+    {
+        bits.reset_all();
+    }
+
+    // Returns the number of bits in the filter.
+    size_t bit_count() const noexcept
+    {
+        return bits.size();
+    }
+
+    // Returns the number of bits probed per key.
+    uint32_t hash_count() const noexcept
+    {
+        return hashes;
+    }
+
+    // Returns the size of the bit array in bytes.
+    size_t byte_size() const noexcept
+    {
+        return bits.word_count() * sizeof(uint32_t);
+    }
+
+    // Estimates the current false positive rate from the fraction of set bits. It grows past the rate
+    // requested in init() once more keys than expected are added. Counts every bit, so keep it out of hot paths.
+    float estimated_false_positive_rate() const noexcept
+    {
+        if (bits.size() == 0) {
+            return 0.0f;
+        }
+        return (float)std::pow((double)bits.count() / (double)bits.size(), (double)hashes);
+    }
+
+private:
+    static constexpr double LN2 = 0.69314718055994530942;
+
+    // Sets (Add) or tests the bits of a key. Returns whether all of them were already set.
+    template <bool Add>
+    bool probe(const void *data, size_t len) noexcept
+    {
+        const uint64_t m = bits.size();
+        uint32_t *words = bits.words();
+        uint32_t h1, h2;
+        bool found = true;
+
+        if (m == 0) {
+            return false;
+        }
+        h1 = mix(fnv1a32(data, len));
+        h2 = mix(h1 + 0x9E3779B9u) | 1u;
+        for (uint32_t i = 0; i < hashes; i++) {
+            // Maps the 32-bit probe onto [0, m) with a multiply instead of a modulo.
+            uint32_t pos = (uint32_t)(((uint64_t)h1 * m) >> 32);
+            uint32_t mask = 1u << (pos % 32);
+
+            if (!(words[pos / 32] & mask)) {
+                if (!Add) {
+                    return false;
+                }
+                found = false;
+                words[pos / 32] |= mask;
+            }
+            h1 += h2;
+        }
+        return found;
+    }
+
+    // Spreads the FNV-1a bits so the high bits used to pick positions depend on every input byte.
+    static uint32_t mix(uint32_t h) noexcept
+    {
+        h ^= h >> 16;
+        h *= 0x85EBCA6Bu;
+        h ^= h >> 13;
+        h *= 0xC2B2AE35u;
+        h ^= h >> 16;
+        return h;
+    }
+
+private:
+    dynamic_bitset bits;
+    uint32_t hashes{0};
+};
+
+} // namespace lightstd
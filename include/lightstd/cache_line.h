@@ -0,0 +1,16 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+// Size used to keep data written by different cores on separate cache lines. Internal SRAM is not
+// cached on the ESP32 family, but PSRAM and host builds are, and a shared line would bounce between
+// cores on every access. Override it to match the target if needed.
+#ifndef LIGHTSTD_CACHE_LINE_SIZE
+    #if defined(__XTENSA__) || defined(__riscv)
+        #define LIGHTSTD_CACHE_LINE_SIZE 32
+    #else
+        #define LIGHTSTD_CACHE_LINE_SIZE 64
+    #endif
+#endif // !LIGHTSTD_CACHE_LINE_SIZE
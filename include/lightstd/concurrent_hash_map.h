@@ -0,0 +1,217 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "mutex.h"
+#include "unordered_map.h"
+#include <esp_err.h>
+#include <cstdint>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Thread-safe hash map split into ShardCount static_hash_map shards, each one guarded by its own mutex.
+// A key always lives in the shard selected by its hash, so tasks working on different keys rarely contend,
+// unlike a single map behind one RWMutex where every lookup serializes on the same semaphores.
+// Another task may erase an entry at any time, so values are never handed out by pointer: find() copies
+// the value out and visit() runs a callback on it while its shard is locked.
+// NOTE: Callbacks run with a shard lock held. Keep them short and do not access the same map from them.
+template<typename K, typename V, typename HashFn = static_hash_map_default_hash<K>, size_t ShardCount = 8,
+         typename KeyEqual = static_hash_map_default_equal<K>>
+class concurrent_hash_map
+{
+    static_assert(ShardCount > 0 && ShardCount <= 256 && (ShardCount & (ShardCount - 1)) == 0,
+                  "concurrent_hash_map: ShardCount must be a power of two up to 256.");
+
+public:
+    // Creates an empty map with no allocated shards.
+    concurrent_hash_map() = default;
+    concurrent_hash_map(const concurrent_hash_map&) = delete;
+    concurrent_hash_map(concurrent_hash_map&&) = delete;
+
+    // Releases all shards.
+    ~concurrent_hash_map()
+    {
+        deinit();
+    }
+
+    concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+    concurrent_hash_map& operator=(concurrent_hash_map&&) = delete;
+
+    // Allocates the shards, splitting tableSize slots evenly between them.
+    esp_err_t init(size_t tableSize) noexcept
+    {
+        size_t shardSize;
+
+        if (tableSize < 1) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        shardSize = (tableSize + ShardCount - 1) / ShardCount;
+        for (size_t i = 0; i < ShardCount; i++) {
+            AutoMutex lock(shards[i].mtx);
+            esp_err_t err = shards[i].map.init(shardSize);
+
+            if (err != ESP_OK) {
+                for (size_t j = 0; j < i; j++) {
+                    shards[j].map.deinit();
+                }
+                return err;
+            }
+        }
+
+        // Done
+        return ESP_OK;
+    }
+
+    // Releases all shards and resets the map state.
+    void deinit() noexcept
+    {
+        for (size_t i = 0; i < ShardCount; i++) {
+            AutoMutex lock(shards[i].mtx);
+
+            shards[i].map.deinit();
+        }
+    }
+
+    // Releases all shards and resets the map state.
+    void done() noexcept
+    {
+        deinit();
+    }
+
+    // Inserts a new key or updates the value of an existing key. Returns false if the shard of the key is full.
+    bool insert(const K& key, const V& value, bool* inserted = nullptr) noexcept
+    {
+        Shard_t &shard = shardFor(key);
+        AutoMutex lock(shard.mtx);
+
+        return shard.map.insert(key, value, inserted) != nullptr;
+    }
+
+    // Copies the value of a key into value. Returns false if the key is not found.
+    bool find(const K& key, V& value) noexcept
+    {
+        Shard_t &shard = shardFor(key);
+        AutoMutex lock(shard.mtx);
+        V *found = shard.map.find(key);
+
+        if (!found) {
+            return false;
+        }
+        value = *found;
+        return true;
+    }
+
+    // Runs fn(V&) on the value of a key while its shard is locked. Returns false if the key is not found.
+    template <class Fn>
+    bool visit(const K& key, Fn&& fn) noexcept
+    {
+        Shard_t &shard = shardFor(key);
+        AutoMutex lock(shard.mtx);
+        V *found = shard.map.find(key);
+
+        if (!found) {
+            return false;
+        }
+        fn(*found);
+        return true;
+    }
+
+    // Reports whether the requested key exists in the map.
+    bool contains(const K& key) noexcept
+    {
+        Shard_t &shard = shardFor(key);
+        AutoMutex lock(shard.mtx);
+
+        return shard.map.contains(key);
+    }
+
+    // Removes a key.
+    bool erase(const K& key) noexcept
+    {
+        Shard_t &shard = shardFor(key);
+        AutoMutex lock(shard.mtx);
+
+        return shard.map.erase(key);
+    }
+
+    // Returns the number of entries. Shards are counted one at a time, so the total is only exact
+    // when no other task is modifying the map.
+    size_t size() noexcept
+    {
+        size_t total = 0;
+
+        for (size_t i = 0; i < ShardCount; i++) {
+            AutoMutex lock(shards[i].mtx);
+
+            total += shards[i].map.size();
+        }
+        return total;
+    }
+
+    // Reports whether the map contains no entries. Same caveat as size().
+    bool empty() noexcept
+    {
+        return size() == 0;
+    }
+
+    // Removes all entries without releasing the shard allocations.
+    void clear() noexcept
+    {
+        for (size_t i = 0; i < ShardCount; i++) {
+            AutoMutex lock(shards[i].mtx);
+
+            shards[i].map.clear();
+        }
+    }
+
+    // Rebuilds every shard to remove accumulated tombstones.
+    void compact() noexcept
+    {
+        for (size_t i = 0; i < ShardCount; i++) {
+            AutoMutex lock(shards[i].mtx);
+
+            shards[i].map.compact();
+        }
+    }
+
+    // Runs fn(const K&, V&) on every entry, locking one shard at a time.
+    template <class Fn>
+    void for_each(Fn&& fn) noexcept
+    {
+        for (size_t i = 0; i < ShardCount; i++) {
+            AutoMutex lock(shards[i].mtx);
+
+            for (auto it = shards[i].map.begin(); it != shards[i].map.end(); ++it) {
+                auto entry = *it;
+
+                fn(static_cast<const K&>(entry.key), entry.value);
+            }
+        }
+    }
+
+private:
+    typedef struct Shard_s {
+        Mutex mtx;
+        static_hash_map<K, V, HashFn, hash_map_layout_interleaved, KeyEqual> map;
+    } Shard_t;
+
+    // Picks the shard from the top bits of a remixed hash. Each shard indexes its table with the plain
+    // hash, so taking low bits here would leave most slots of every shard unused.
+    Shard_t& shardFor(const K& key) noexcept
+    {
+        uint32_t mixed = hasher(key) * 2654435761u;
+
+        return shards[(mixed >> 24) & (ShardCount - 1)];
+    }
+
+private:
+    HashFn hasher;
+    Shard_t shards[ShardCount];
+};
+
+} // namespace lightstd
@@ -0,0 +1,568 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "allocator.h"
+#include "string_view.h"
+#include "unordered_map.h"
+#include "vector.h"
+#include <algorithm>
+#include <assert.h>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Default key ordering using operator<.
+template<typename K>
+struct flat_map_default_less
+{
+    // Reports whether a sorts before b.
+    bool operator()(const K& a, const K& b) const
+    {
+        return a < b;
+    }
+};
+
+// Orders lightstd::string, string_view and C string keys by content. It is transparent: a string-keyed
+// flat_map can be searched with any of those types.
+struct string_key_less
+{
+    using is_transparent = void;
+
+    // Reports whether a sorts before b.
+    bool operator()(string_view a, string_view b) const noexcept
+    {
+        return a < b;
+    }
+};
+
+template<>
+struct flat_map_default_less<string> : string_key_less {};
+template<>
+struct flat_map_default_less<string_view> : string_key_less {};
+template<>
+struct flat_map_default_less<const char*> : string_key_less {};
+template<>
+struct flat_map_default_less<char*> : string_key_less {};
+
+namespace detail {
+
+// Enables lookups by Q in a flat container keyed by K when the ordering accepts other key types.
+template <class K, class Q, class Less>
+using enable_transparent_compare_t = std::enable_if_t<!std::is_same_v<std::decay_t<Q>, K> && is_transparent<Less>::value, int>;
+
+// Shared implementation of flat_map and flat_set: a vector of items kept sorted by the key that KeyOf
+// extracts from each item.
+template <class T, class KeyOf, class Less>
+class sorted_array
+{
+public:
+    static constexpr size_t npos = (size_t)-1;
+
+    sorted_array(IAllocator *_alloc) noexcept : items(_alloc)
+    {
+    }
+
+    // Returns the index of the first item whose key is not less than key. The loop has a fixed trip count
+    // and the compare result only selects the next base, so there are no mispredicted branches to pay for.
+    template <class Q>
+    size_t lowerBound(const Q& key) const noexcept
+    {
+        const T *base = items.data();
+        size_t n = items.size();
+
+        assert(sorted);
+        if (n == 0) {
+            return 0;
+        }
+        while (n > 1) {
+            size_t half = n / 2;
+
+            base = less(keyOf(base[half]), key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<size_t>(base - items.data()) + (less(keyOf(*base), key) ? 1 : 0);
+    }
+
+    // Returns the index of the item holding key, or npos.
+    template <class Q>
+    size_t find(const Q& key) const noexcept
+    {
+        size_t idx = lowerBound(key);
+
+        return (idx < items.size() && !less(key, keyOf(items[idx]))) ? idx : npos;
+    }
+
+    // Moves item into position idx, shifting the following items up by one.
+    bool insertAt(size_t idx, T&& item) noexcept
+    {
+        size_t last = items.size();
+
+        if (!items.push_back(std::move(item))) {
+            return false;
+        }
+        if (idx < last) {
+            T *p = items.data();
+
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                alignas(T) unsigned char tmp[sizeof(T)];
+
+                memcpy(tmp, static_cast<void*>(p + last), sizeof(T));
+                memmove(static_cast<void*>(p + idx + 1), p + idx, (last - idx) * sizeof(T));
+                memcpy(static_cast<void*>(p + idx), tmp, sizeof(T));
+            }
+            else {
+                vector_rotate(p, idx, last, last + 1);
+            }
+        }
+        return true;
+    }
+
+    // Appends an item without ordering it. The array stays searchable only if the key sorts after the
+    // current last one; otherwise build() must run before the next lookup.
+    bool append(T&& item) noexcept
+    {
+        if (sorted && items.size() > 0 && !less(keyOf(items.back()), keyOf(item))) {
+            sorted = false;
+        }
+        return items.push_back(std::move(item));
+    }
+
+    // Sorts the items appended since the last build and collapses duplicate keys into a single item.
+    void build() noexcept
+    {
+        size_t out;
+
+        if (sorted) {
+            return;
+        }
+        std::sort(items.begin(), items.end(), [this](const T& a, const T& b) {
+            return less(keyOf(a), keyOf(b));
+        });
+        out = 1;
+        for (size_t i = 1; i < items.size(); i++) {
+            if (less(keyOf(items[out - 1]), keyOf(items[i]))) {
+                if (out != i) {
+                    items[out] = std::move(items[i]);
+                }
+                out++;
+            }
+        }
+        items.resize_down(out);
+        sorted = true;
+    }
+
+public:
+    vector<T> items;
+    KeyOf keyOf;
+    Less less;
+    bool sorted{true};
+};
+
+} // namespace detail
+
+// Ordered map stored as a sorted lightstd::vector of key/value entries. Lookups are a branchless binary
+// search over contiguous memory, with no hashing and no slack slots, which suits small tables that are
+// built once and read often, such as config schemas and command dispatch tables.
+// Tables can be filled in bulk: append() every entry and call build() once to sort them. Entries appended
+// in key order need no sorting at all. insert() and erase() also work but shift the following entries.
+// Iteration visits entries in key order.
+// NOTE: Pointers and iterators are invalidated by any insert, append, build or erase.
+// NOTE: Do not modify the key of an entry through an iterator.
+template<typename K, typename V, typename Less = flat_map_default_less<K>>
+class flat_map
+{
+public:
+    typedef struct Entry_s {
+        K key;
+        V value;
+    } Entry_t;
+
+    using iterator        = Entry_t*;
+    using const_iterator  = const Entry_t*;
+
+private:
+    struct KeyOf
+    {
+        const K& operator()(const Entry_t& entry) const noexcept
+        {
+            return entry.key;
+        }
+    };
+
+public:
+    // Creates an empty map using the provided allocator or the default one.
+    flat_map(IAllocator *_alloc = nullptr) noexcept : tree(_alloc)
+    {
+    }
+
+    flat_map(const flat_map&) = delete;
+    flat_map(flat_map&&) noexcept = default;
+
+    flat_map& operator=(const flat_map&) = delete;
+    flat_map& operator=(flat_map&&) noexcept = default;
+
+    // Ensures capacity for at least the requested number of entries.
+    [[nodiscard]] bool reserve(size_t count) noexcept
+    {
+        return tree.items.reserve(count);
+    }
+
+    // Releases unused capacity, typically after the table is fully built.
+    [[nodiscard]] bool shrink_to_fit() noexcept
+    {
+        return tree.items.shrink_to_fit();
+    }
+
+    // Inserts a new key in order or updates the value of an existing key. Returns nullptr if the allocation fails.
+    V* insert(const K& key, const V& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(key, value, inserted);
+    }
+
+    // Inserts a new key or updates the value of an existing key, moving the value in.
+    V* insert(const K& key, V&& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(key, std::move(value), inserted);
+    }
+
+    // Inserts a new key or updates the value of an existing key, moving the key in.
+    // The key is left untouched if it already exists.
+    V* insert(K&& key, const V& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(std::move(key), value, inserted);
+    }
+
+    // Inserts a new key or updates the value of an existing key, moving both in.
+    // The key is left untouched if it already exists.
+    V* insert(K&& key, V&& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(std::move(key), std::move(value), inserted);
+    }
+
+    // Appends an entry without ordering it. Call build() after the last append and before any lookup.
+    template <class KArg, class VArg>
+    [[nodiscard]] bool append(KArg&& key, VArg&& value) noexcept
+    {
+        return tree.append(Entry_t{K(std::forward<KArg>(key)), V(std::forward<VArg>(value))});
+    }
+
+    // Sorts the appended entries. If a key was appended more than once, only one of its entries is kept.
+    void build() noexcept
+    {
+        tree.build();
+    }
+
+    // Returns the value pointer for a key or nullptr if not found.
+    V* find(const K& key) noexcept
+    {
+        return findImpl(key);
+    }
+
+    // Returns the value pointer for a key or nullptr if not found.
+    const V* find(const K& key) const noexcept
+    {
+        return const_cast<flat_map*>(this)->findImpl(key);
+    }
+
+    // Returns the value pointer for a key of another type, such as a C string in a string-keyed map,
+    // without building a temporary K. Needs a transparent Less.
+    template <class Q, detail::enable_transparent_compare_t<K, Q, Less> = 0>
+    V* find(const Q& key) noexcept
+    {
+        return findImpl(key);
+    }
+
+    // Reports whether the requested key exists in the map.
+    bool contains(const K& key) const noexcept
+    {
+        return tree.find(key) != tree.npos;
+    }
+
+    // Reports whether a key of another type exists in the map. Needs a transparent Less.
+    template <class Q, detail::enable_transparent_compare_t<K, Q, Less> = 0>
+    bool contains(const Q& key) const noexcept
+    {
+        return tree.find(key) != tree.npos;
+    }
+
+    // Returns an iterator to the first entry whose key is not less than key, for ordered range scans.
+    iterator lower_bound(const K& key) noexcept
+    {
+        return tree.items.begin() + tree.lowerBound(key);
+    }
+
+    // Returns an iterator to the first entry whose key is not less than key, for ordered range scans.
+    const_iterator lower_bound(const K& key) const noexcept
+    {
+        return tree.items.begin() + tree.lowerBound(key);
+    }
+
+    // Removes a key, shifting the following entries down.
+    bool erase(const K& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Removes a key of another type. Needs a transparent Less.
+    template <class Q, detail::enable_transparent_compare_t<K, Q, Less> = 0>
+    bool erase(const Q& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Returns the number of entries.
+    size_t size() const noexcept
+    {
+        return tree.items.size();
+    }
+
+    // Reports whether the map contains no entries.
+    bool empty() const noexcept
+    {
+        return tree.items.empty();
+    }
+
+    // Removes all entries while keeping the current allocation.
+    void clear() noexcept
+    {
+        tree.items.clear();
+        tree.sorted = true;
+    }
+
+    // Returns an iterator to the entry with the smallest key.
+    iterator begin() noexcept
+    {
+        assert(tree.sorted);
+        return tree.items.begin();
+    }
+
+    // Returns a const iterator to the entry with the smallest key.
+    const_iterator begin() const noexcept
+    {
+        assert(tree.sorted);
+        return tree.items.begin();
+    }
+
+    // Returns an iterator one past the last entry.
+    iterator end() noexcept
+    {
+        return tree.items.end();
+    }
+
+    // Returns a const iterator one past the last entry.
+    const_iterator end() const noexcept
+    {
+        return tree.items.end();
+    }
+
+private:
+    template <class KArg, class VArg>
+    V* insertOrAssign(KArg&& key, VArg&& value, bool* inserted) noexcept
+    {
+        size_t idx = tree.lowerBound(key);
+
+        if (inserted) {
+            *inserted = false;
+        }
+        if (idx < tree.items.size() && !tree.less(key, tree.items[idx].key)) {
+            tree.items[idx].value = std::forward<VArg>(value);
+            return &tree.items[idx].value;
+        }
+        // Build the entry first, growing the vector would leave arguments that reference an entry dangling.
+        if (!tree.insertAt(idx, Entry_t{K(std::forward<KArg>(key)), V(std::forward<VArg>(value))})) {
+            return nullptr;
+        }
+        if (inserted) {
+            *inserted = true;
+        }
+        return &tree.items[idx].value;
+    }
+
+    template <class Q>
+    V* findImpl(const Q& key) noexcept
+    {
+        size_t idx = tree.find(key);
+
+        return (idx != tree.npos) ? &tree.items[idx].value : nullptr;
+    }
+
+    template <class Q>
+    bool eraseImpl(const Q& key) noexcept
+    {
+        size_t idx = tree.find(key);
+
+        if (idx == tree.npos) {
+            return false;
+        }
+        tree.items.erase(tree.items.begin() + idx, tree.items.begin() + idx + 1);
+        return true;
+    }
+
+private:
+    detail::sorted_array<Entry_t, KeyOf, Less> tree;
+};
+
+// Ordered set stored as a sorted lightstd::vector. Same trade-offs and bulk build support as flat_map.
+// NOTE: Pointers and iterators are invalidated by any insert, append, build or erase.
+template<typename K, typename Less = flat_map_default_less<K>>
+class flat_set
+{
+public:
+    using iterator        = const K*;
+    using const_iterator  = const K*;
+
+private:
+    struct KeyOf
+    {
+        const K& operator()(const K& key) const noexcept
+        {
+            return key;
+        }
+    };
+
+public:
+    // Creates an empty set using the provided allocator or the default one.
+    flat_set(IAllocator *_alloc = nullptr) noexcept : tree(_alloc)
+    {
+    }
+
+    flat_set(const flat_set&) = delete;
+    flat_set(flat_set&&) noexcept = default;
+
+    flat_set& operator=(const flat_set&) = delete;
+    flat_set& operator=(flat_set&&) noexcept = default;
+
+    // Ensures capacity for at least the requested number of keys.
+    [[nodiscard]] bool reserve(size_t count) noexcept
+    {
+        return tree.items.reserve(count);
+    }
+
+    // Releases unused capacity, typically after the set is fully built.
+    [[nodiscard]] bool shrink_to_fit() noexcept
+    {
+        return tree.items.shrink_to_fit();
+    }
+
+    // Inserts a key in order. Returns false only if the allocation fails.
+    [[nodiscard]] bool insert(const K& key, bool* inserted = nullptr) noexcept
+    {
+        return insertImpl(key, inserted);
+    }
+
+    // Inserts a key in order, moving it in.
+    [[nodiscard]] bool insert(K&& key, bool* inserted = nullptr) noexcept
+    {
+        return insertImpl(std::move(key), inserted);
+    }
+
+    // Appends a key without ordering it. Call build() after the last append and before any lookup.
+    template <class KArg>
+    [[nodiscard]] bool append(KArg&& key) noexcept
+    {
+        return tree.append(K(std::forward<KArg>(key)));
+    }
+
+    // Sorts the appended keys and drops duplicates.
+    void build() noexcept
+    {
+        tree.build();
+    }
+
+    // Reports whether the requested key exists in the set.
+    bool contains(const K& key) const noexcept
+    {
+        return tree.find(key) != tree.npos;
+    }
+
+    // Reports whether a key of another type exists in the set. Needs a transparent Less.
+    template <class Q, detail::enable_transparent_compare_t<K, Q, Less> = 0>
+    bool contains(const Q& key) const noexcept
+    {
+        return tree.find(key) != tree.npos;
+    }
+
+    // Returns an iterator to the first key that is not less than key, for ordered range scans.
+    const_iterator lower_bound(const K& key) const noexcept
+    {
+        return tree.items.begin() + tree.lowerBound(key);
+    }
+
+    // Removes a key, shifting the following keys down.
+    bool erase(const K& key) noexcept
+    {
+        size_t idx = tree.find(key);
+
+        if (idx == tree.npos) {
+            return false;
+        }
+        tree.items.erase(tree.items.begin() + idx, tree.items.begin() + idx + 1);
+        return true;
+    }
+
+    // Returns the number of keys.
+    size_t size() const noexcept
+    {
+        return tree.items.size();
+    }
+
+    // Reports whether the set contains no keys.
+    bool empty() const noexcept
+    {
+        return tree.items.empty();
+    }
+
+    // Removes all keys while keeping the current allocation.
+    void clear() noexcept
+    {
+        tree.items.clear();
+        tree.sorted = true;
+    }
+
+    // Returns an iterator to the smallest key.
+    const_iterator begin() const noexcept
+    {
+        assert(tree.sorted);
+        return tree.items.begin();
+    }
+
+    // Returns an iterator one past the largest key.
+    const_iterator end() const noexcept
+    {
+        return tree.items.end();
+    }
+
+private:
+    template <class KArg>
+    bool insertImpl(KArg&& key, bool* inserted) noexcept
+    {
+        size_t idx = tree.lowerBound(key);
+
+        if (inserted) {
+            *inserted = false;
+        }
+        if (idx < tree.items.size() && !tree.less(key, tree.items[idx])) {
+            return true;
+        }
+        if (!tree.insertAt(idx, K(std::forward<KArg>(key)))) {
+            return false;
+        }
+        if (inserted) {
+            *inserted = true;
+        }
+        return true;
+    }
+
+private:
+    detail::sorted_array<K, KeyOf, Less> tree;
+};
+
+} // namespace lightstd
@@ -10,6 +10,13 @@
 //     a few captures, plain function pointers, etc.)
 //   - Correct value semantics: callable is owned (copied/moved into buffer)
 //   - Correct copy/move via a vtable of plain function pointers
+//   - Trivially copyable callables (captureless lambdas, lambdas capturing
+//     pointers, references or integers) skip the vtable on copy, move and
+//     destroy: they are relocated with memcpy and never destroyed
+//
+// For synchronous callbacks that do not need to outlive the call, prefer
+// function_ref (below): it never copies the callable at all. For move-only
+// callables, e.g. a lambda that owns a lightstd::vector, use unique_function.
 //
 // Template parameters:
 //   Signature  — the call signature, e.g. void(int, float)
@@ -40,6 +47,8 @@
 
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <new>
 #include <type_traits>
 #include <utility>
@@ -48,13 +57,12 @@
 
 namespace lightstd {
 
-// Forward declaration of primary template
-template<typename Signature, std::size_t SboSize = 32>
-class light_function;
+namespace detail {
 
-// Partial specialisation for callable signatures
-template<typename R, typename... Args, std::size_t SboSize>
-class light_function<R(Args...), SboSize>
+// Storage, vtable and move/destroy logic shared by light_function and unique_function. The derived
+// classes add construction and assignment; light_function also adds the copy entry to the vtable.
+template<typename R, std::size_t SboSize, typename... Args>
+class function_base
 {
 public:
     static constexpr std::size_t SBO_SIZE  = SboSize;
@@ -64,6 +72,235 @@ public:
     // standard C++) and silently route every callable through the heap.
     static_assert(SboSize > 0, "light_function: SboSize must be at least 1");
 
+    // Invocation.
+    //
+    // Takes Args... by value, not Args&&...:
+    //   - Args&&... would refuse to bind lvalue arguments for value types,
+    //     e.g. light_function<int(int)> called as f(x) where x is an int
+    //     lvalue would fail to compile (can't bind int&& to int lvalue).
+    //   - Args... means the caller's argument is copied/moved once into the
+    //     parameter pack at the call site, then forwarded into invoke().
+    //     For move-only types (e.g. unique_ptr) the caller passes
+    //     std::move(x) explicitly, which move-constructs into args.
+    //   This matches std::function's calling convention exactly.
+    R operator()(Args... args) const
+    {
+        if (!m_vtable) {
+            // Calling an empty light_function is a hard programming error.
+            abort();
+        }
+        // const_cast: the stored callable may have mutable state (e.g. a
+        // mutable lambda). This mirrors std::function behaviour.
+        return m_vtable->invoke(const_cast<function_base*>(this)->active_storage(), std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return m_vtable != nullptr;
+    }
+
+protected:
+    // Vtable: plain function pointers — no virtual dispatch, no RTTI.
+    // alloc_size carries sizeof(F)
+    // move_destroy and destroy are null for trivially copyable callables,
+    // which move_from relocates with memcpy and destroy() skips.
+    struct Vtable {
+        R           (*invoke)       (void* storage, Args&&... args);
+        void        (*move_destroy) (void* dst, void* src); // move dst, destroy src
+        void        (*destroy)      (void* storage);
+        std::size_t alloc_size;   // sizeof(F) — used when heap path is taken
+    };
+
+    function_base() noexcept = default;
+
+    function_base(const function_base&) = delete;
+    function_base& operator=(const function_base&) = delete;
+
+    ~function_base()
+    {
+        destroy();
+    }
+
+    template<typename F>
+    static R invoke_fn(void* s, Args&&... args)
+    {
+        // Forward each argument to preserve move semantics.
+        return (*static_cast<F*>(s))(std::forward<Args>(args)...);
+    }
+
+    template<typename F>
+    static constexpr Vtable make_vtable() noexcept
+    {
+        if constexpr (std::is_trivially_copyable<F>::value) {
+            // Trivially copyable also implies a trivial destructor, so the
+            // bytes are the whole object: memcpy relocates it and there is
+            // nothing to destroy. Only invoke needs an indirect call.
+            return Vtable{
+                invoke_fn<F>,
+                nullptr,    // move_destroy → memcpy
+                nullptr,    // destroy      → nothing to do
+                sizeof(F)   // alloc_size
+            };
+        }
+        else {
+            return Vtable{
+                invoke_fn<F>,
+                // move-construct dst from src, then destroy src in-place
+                [](void* dst, void* src) {
+                    ::new (dst) F(std::move(*static_cast<F*>(src)));
+                    static_cast<F*>(src)->~F();
+                },
+                // destroy in-place
+                [](void* s) {
+                    static_cast<F*>(s)->~F();
+                },
+                sizeof(F)   // alloc_size
+            };
+        }
+    }
+
+    void* active_storage() noexcept
+    {
+         return m_heap ? m_heap : m_sbo;
+    }
+    const void* active_storage() const noexcept
+    {
+        return m_heap ? m_heap : m_sbo;
+    }
+
+    // Constructs the callable inline when it fits, on the heap otherwise, and
+    // installs its vtable. The derived class checks the nothrow contracts first,
+    // so the placement-new cannot throw regardless of value category.
+    template<typename Fd, typename F>
+    void store(F&& f, const Vtable* vtable) noexcept
+    {
+        if constexpr (sizeof(Fd) <= SBO_SIZE && alignof(Fd) <= SBO_ALIGN) {
+            m_heap = nullptr;
+            ::new (static_cast<void*>(m_sbo)) Fd(std::forward<F>(f));
+        }
+        else {
+            // Use std::nothrow: under -fno-exceptions the default ::operator new
+            // may still invoke the new-handler or behave implementation-defined.
+            // std::nothrow guarantees a nullptr return on failure.
+            void* mem = ::operator new(sizeof(Fd), std::nothrow);
+            if (!mem) {
+                // Out of heap memory — unrecoverable on ESP-IDF.
+                abort();
+            }
+            m_heap = mem;
+            ::new (m_heap) Fd(std::forward<F>(f));
+        }
+        m_vtable = vtable;
+    }
+
+    void destroy() noexcept
+    {
+        if (m_vtable) {
+            if (m_vtable->destroy) {
+                m_vtable->destroy(active_storage());
+            }
+            if (m_heap) {
+                ::operator delete(m_heap);
+                m_heap = nullptr;
+            }
+            m_vtable = nullptr;
+        }
+    }
+
+    // Relocates a trivially copyable callable stored inline. Copies the whole
+    // buffer rather than alloc_size bytes: a constant-size memcpy of a small
+    // buffer compiles down to a few word moves instead of a library call.
+    void copy_sbo(const function_base& other) noexcept
+    {
+        std::memcpy(m_sbo, other.m_sbo, SBO_SIZE);
+    }
+
+    // move_from is noexcept because:
+    //   • Heap path:  pointer steal only — no construction, no throw.
+    //   • SBO path:   calls F's move constructor via move_destroy.
+    //                 If that move constructor throws (pathological — well-
+    //                 designed types have noexcept move ctors), noexcept
+    //                 causes std::terminate.  This matches the contract
+    //                 std::function imposes and is acceptable because:
+    //                   1. Move constructors that throw are an anti-pattern.
+    //                   2. On -fno-exceptions builds this path is unreachable.
+    //                 If you need to store a type with a throwing move ctor,
+    //                 wrap it in std::unique_ptr so the pointer (noexcept move)
+    //                 is what gets stored.
+    void move_from(function_base& other) noexcept
+    {
+        if (!other.m_vtable) {
+            return;
+        }
+
+        if (other.m_heap) {
+            // Steal the heap pointer — no allocation needed.
+            m_heap = other.m_heap;
+            other.m_heap = nullptr;
+        }
+        else {
+            m_heap = nullptr;
+            if (other.m_vtable->move_destroy) {
+                // Move-construct into our SBO, then destroy the source SBO object.
+                other.m_vtable->move_destroy(m_sbo, other.m_sbo);
+            }
+            else {
+                copy_sbo(other);
+            }
+        }
+
+        m_vtable       = other.m_vtable;
+        other.m_vtable = nullptr;
+    }
+
+    // Storage
+    alignas(SBO_ALIGN) unsigned char m_sbo[SBO_SIZE];
+
+    void*         m_heap{nullptr};   // non-null => callable lives on the heap
+    const Vtable* m_vtable{nullptr}; // null => empty
+};
+
+// Non-member comparison with nullptr, for light_function and unique_function.
+template<typename R, std::size_t S, typename... Args>
+bool operator==(const function_base<R, S, Args...>& f, std::nullptr_t) noexcept
+{
+    return !f;
+}
+
+template<typename R, std::size_t S, typename... Args>
+bool operator==(std::nullptr_t, const function_base<R, S, Args...>& f) noexcept
+{
+    return !f;
+}
+
+template<typename R, std::size_t S, typename... Args>
+bool operator!=(const function_base<R, S, Args...>& f, std::nullptr_t) noexcept
+{
+    return !!f;
+}
+
+template<typename R, std::size_t S, typename... Args>
+bool operator!=(std::nullptr_t, const function_base<R, S, Args...>& f) noexcept
+{
+    return !!f;
+}
+
+} // namespace detail
+
+// Forward declaration of primary template
+template<typename Signature, std::size_t SboSize = 32>
+class light_function;
+
+// Partial specialisation for callable signatures
+template<typename R, typename... Args, std::size_t SboSize>
+class light_function<R(Args...), SboSize> : public detail::function_base<R, SboSize, Args...>
+{
+    using base_t = detail::function_base<R, SboSize, Args...>;
+    using typename base_t::Vtable;
+    using base_t::m_heap;
+    using base_t::m_vtable;
+
+public:
     light_function() noexcept = default;
     light_function(std::nullptr_t) noexcept {}
 
@@ -89,18 +326,13 @@ public:
 
     light_function(light_function&& other) noexcept
     {
-        move_from(other);
-    }
-
-    ~light_function()
-    {
-        destroy();
+        this->move_from(other);
     }
 
     light_function& operator=(const light_function& other) noexcept
     {
         if (this != &other) {
-            destroy();
+            this->destroy();
             copy_from(other);
         }
         return *this;
@@ -109,15 +341,15 @@ public:
     light_function& operator=(light_function&& other) noexcept
     {
         if (this != &other) {
-            destroy();
-            move_from(other);
+            this->destroy();
+            this->move_from(other);
         }
         return *this;
     }
 
     light_function& operator=(std::nullptr_t) noexcept
     {
-        destroy();
+        this->destroy();
         return *this;
     }
 
@@ -127,38 +359,11 @@ public:
     >
     light_function& operator=(F&& f) noexcept
     {
-        destroy();
+        this->destroy();
         assign(std::forward<F>(f));
         return *this;
     }
 
-    // Invocation.
-    //
-    // Takes Args... by value, not Args&&...:
-    //   - Args&&... would refuse to bind lvalue arguments for value types,
-    //     e.g. light_function<int(int)> called as f(x) where x is an int
-    //     lvalue would fail to compile (can't bind int&& to int lvalue).
-    //   - Args... means the caller's argument is copied/moved once into the
-    //     parameter pack at the call site, then forwarded into invoke().
-    //     For move-only types (e.g. unique_ptr) the caller passes
-    //     std::move(x) explicitly, which move-constructs into args.
-    //   This matches std::function's calling convention exactly.
-    R operator()(Args... args) const
-    {
-        if (!m_vtable) {
-            // Calling an empty light_function is a hard programming error.
-            abort();
-        }
-        // const_cast: the stored callable may have mutable state (e.g. a
-        // mutable lambda). This mirrors std::function behaviour.
-        return m_vtable->invoke(const_cast<light_function*>(this)->active_storage(), std::forward<Args>(args)...);
-    }
-
-    explicit operator bool() const noexcept
-    {
-        return m_vtable != nullptr;
-    }
-
     void swap(light_function& other) noexcept
     {
         light_function tmp(std::move(other));
@@ -167,90 +372,38 @@ public:
     }
 
 private:
-    // Vtable: plain function pointers — no virtual dispatch, no RTTI.
-    // alloc_size carries sizeof(F)
-    struct Vtable {
-        R           (*invoke)       (void* storage, Args&&... args);
+    // The shared vtable plus the copy entry, which is null for trivially
+    // copyable callables: copy_from relocates those with memcpy.
+    struct CopyVtable : Vtable {
         void        (*copy)         (void* dst, const void* src);
-        void        (*move_destroy) (void* dst, void* src); // move dst, destroy src
-        void        (*destroy)      (void* storage);
-        std::size_t alloc_size;   // sizeof(F) — used when heap path is taken
     };
 
     template<typename F>
     static const Vtable* vtable_for() noexcept
     {
-        static const Vtable vt = {
-            // invoke — forward each argument to preserve move semantics
-            [](void* s, Args&&... args) -> R {
-                return (*static_cast<F*>(s))(std::forward<Args>(args)...);
-            },
-            // copy-construct dst from src
-            [](void* dst, const void* src) {
-                ::new (dst) F(*static_cast<const F*>(src));
-            },
-            // move-construct dst from src, then destroy src in-place
-            [](void* dst, void* src) {
-                ::new (dst) F(std::move(*static_cast<F*>(src)));
-                static_cast<F*>(src)->~F();
-            },
-            // destroy in-place
-            [](void* s) {
-                static_cast<F*>(s)->~F();
-            },
-            sizeof(F)   // alloc_size
-        };
-        return &vt;
-    }
-
-    // Storage
-    alignas(SBO_ALIGN) unsigned char m_sbo[SBO_SIZE];
-
-    void*         m_heap{nullptr};   // non-null => callable lives on the heap
-    const Vtable* m_vtable{nullptr}; // null => empty
-
-    void* active_storage() noexcept
-    {
-         return m_heap ? m_heap : m_sbo;
-    }
-    const void* active_storage() const noexcept
-    {
-        return m_heap ? m_heap : m_sbo;
-    }
-
-    // Tag-dispatch helpers: SBO vs heap allocation.
-    // Overloads prevent the compiler from instantiating the placement-new
-    // branch with a type that doesn't fit (avoids -Wplacement-new / UB).
-    template<typename Fd, typename F>
-    void store(F&& f, std::true_type /*fits in SBO*/) noexcept
-    {
-        // Noexcept is unconditional here: the static_asserts in assign
-        // guarantee Fd is both nothrow-copy and nothrow-move constructible,
-        // so the placement-new cannot throw regardless of value category.
-        m_heap = nullptr;
-        ::new (static_cast<void*>(m_sbo)) Fd(std::forward<F>(f));
-    }
-
-    template<typename Fd, typename F>
-    void store(F&& f, std::false_type /*too large — use heap*/)
-    {
-        // Use std::nothrow: under -fno-exceptions the default ::operator new
-        // may still invoke the new-handler or behave implementation-defined.
-        // std::nothrow guarantees a nullptr return on failure.
-        void* mem = ::operator new(sizeof(Fd), std::nothrow);
-        if (!mem) {
-            // Out of heap memory — unrecoverable on ESP-IDF.
-            abort();
+        if constexpr (std::is_trivially_copyable<F>::value) {
+            static const CopyVtable vt = {
+                base_t::template make_vtable<F>(),
+                nullptr     // copy → memcpy
+            };
+            return &vt;
+        }
+        else {
+            static const CopyVtable vt = {
+                base_t::template make_vtable<F>(),
+                // copy-construct dst from src
+                [](void* dst, const void* src) {
+                    ::new (dst) F(*static_cast<const F*>(src));
+                }
+            };
+            return &vt;
         }
-        m_heap = mem;
-        ::new (m_heap) Fd(std::forward<F>(f));
     }
 
     template<typename F>
     void assign(F&& f) noexcept
     {
         using Fd = typename std::decay<F>::type;
-        using fits = std::integral_constant<bool, sizeof(Fd) <= SBO_SIZE && alignof(Fd) <= SBO_ALIGN>;
 
         // Compile-time safety contracts:
         //
@@ -310,31 +463,20 @@ private:
                       "light_function: stored callable must be nothrow copy constructible. "
                       "Capture heavy types by reference [&x] instead of by value [x].");
 
-        store<Fd>(std::forward<F>(f), fits{});
-        m_vtable = vtable_for<Fd>();
-    }
-
-    void destroy() noexcept
-    {
-        if (m_vtable) {
-            m_vtable->destroy(active_storage());
-            if (m_heap) {
-                ::operator delete(m_heap);
-                m_heap = nullptr;
-            }
-            m_vtable = nullptr;
-        }
+        this->template store<Fd>(std::forward<F>(f), vtable_for<Fd>());
     }
 
     void copy_from(const light_function& other) noexcept
     {
-        if (!other.m_vtable) {
+        const CopyVtable* vtable = static_cast<const CopyVtable*>(other.m_vtable);
+
+        if (!vtable) {
             return;
         }
 
         if (other.m_heap) {
             // Null-check the allocation; abort() on failure (heap exhausted).
-            void* mem = ::operator new(other.m_vtable->alloc_size, std::nothrow);
+            void* mem = ::operator new(vtable->alloc_size, std::nothrow);
             if (!mem) {
                 abort();
             }
@@ -350,76 +492,201 @@ private:
                 ~HeapGuard() { if (!committed) ::operator delete(ptr); }
             } guard{mem, false};
 
-            other.m_vtable->copy(mem, other.m_heap);
+            if (vtable->copy) {
+                vtable->copy(mem, other.m_heap);
+            }
+            else {
+                std::memcpy(mem, other.m_heap, vtable->alloc_size);
+            }
             guard.committed = true;
             m_heap = mem;
         }
         else {
             m_heap = nullptr;
-            other.m_vtable->copy(m_sbo, other.m_sbo);
+            if (vtable->copy) {
+                vtable->copy(this->m_sbo, other.m_sbo);
+            }
+            else {
+                this->copy_sbo(other);
+            }
         }
 
         // Set vtable last — consistent with assign ordering.
-        m_vtable = other.m_vtable;
+        m_vtable = vtable;
     }
+};
 
-    // move_from is noexcept because:
-    //   • Heap path:  pointer steal only — no construction, no throw.
-    //   • SBO path:   calls F's move constructor via move_destroy.
-    //                 If that move constructor throws (pathological — well-
-    //                 designed types have noexcept move ctors), noexcept
-    //                 causes std::terminate.  This matches the contract
-    //                 std::function imposes and is acceptable because:
-    //                   1. Move constructors that throw are an anti-pattern.
-    //                   2. On -fno-exceptions builds this path is unreachable.
-    //                 If you need to store a type with a throwing move ctor,
-    //                 wrap it in std::unique_ptr so the pointer (noexcept move)
-    //                 is what gets stored.
-    void move_from(light_function& other) noexcept
+// Move-only counterpart of light_function.
+//
+// light_function must be able to copy what it stores, so a lambda that owns a
+// move-only object (lightstd::vector, lightstd::string, std::unique_ptr...)
+// cannot go in it. unique_function drops the copy operations and only requires
+// the callable to be nothrow move constructible, so such a lambda is stored
+// inline in the SBO buffer like any other:
+//
+//   lightstd::vector<uint8_t> payload = ...;
+//   unique_function<void()> job = [buf = std::move(payload)]() mutable {
+//       send(buf.data(), buf.size());
+//   };
+//   queue_deferred(std::move(job));   // the buffer travels with the job
+//
+// SboSize, the trivially copyable fast path and the error policy are the same
+// as light_function's, since both share detail::function_base.
+template<typename Signature, std::size_t SboSize = 32>
+class unique_function;
+
+template<typename R, typename... Args, std::size_t SboSize>
+class unique_function<R(Args...), SboSize> : public detail::function_base<R, SboSize, Args...>
+{
+    using base_t = detail::function_base<R, SboSize, Args...>;
+    using typename base_t::Vtable;
+
+public:
+    unique_function() noexcept = default;
+    unique_function(std::nullptr_t) noexcept {}
+
+    // Construct from any callable, copyable or not. Rvalues are moved in.
+    template<
+        typename F,
+        typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, unique_function>::value>::type
+    >
+    unique_function(F&& f) noexcept
     {
-        if (!other.m_vtable) {
-            return;
-        }
+        assign(std::forward<F>(f));
+    }
 
-        if (other.m_heap) {
-            // Steal the heap pointer — no allocation needed.
-            m_heap = other.m_heap;
-            other.m_heap = nullptr;
-        }
-        else {
-            m_heap = nullptr;
-            // Move-construct into our SBO, then destroy the source SBO object.
-            other.m_vtable->move_destroy(m_sbo, other.m_sbo);
+    unique_function(const unique_function&) = delete;
+
+    unique_function(unique_function&& other) noexcept
+    {
+        this->move_from(other);
+    }
+
+    unique_function& operator=(const unique_function&) = delete;
+
+    unique_function& operator=(unique_function&& other) noexcept
+    {
+        if (this != &other) {
+            this->destroy();
+            this->move_from(other);
         }
+        return *this;
+    }
 
-        m_vtable       = other.m_vtable;
-        other.m_vtable = nullptr;
+    unique_function& operator=(std::nullptr_t) noexcept
+    {
+        this->destroy();
+        return *this;
+    }
+
+    template<
+        typename F,
+        typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, unique_function>::value>::type
+    >
+    unique_function& operator=(F&& f) noexcept
+    {
+        this->destroy();
+        assign(std::forward<F>(f));
+        return *this;
+    }
+
+    void swap(unique_function& other) noexcept
+    {
+        unique_function tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+private:
+    template<typename F>
+    static const Vtable* vtable_for() noexcept
+    {
+        static constexpr Vtable vt = base_t::template make_vtable<F>();
+
+        return &vt;
+    }
+
+    template<typename F>
+    void assign(F&& f) noexcept
+    {
+        using Fd = typename std::decay<F>::type;
+
+        // Moves happen inside noexcept move_from(); see light_function::assign
+        // for the full rationale. Copyability is deliberately not required.
+        static_assert(std::is_nothrow_move_constructible<Fd>::value, "unique_function: stored callable must be nothrow move constructible.");
+        static_assert(std::is_nothrow_constructible<Fd, F&&>::value,
+                      "unique_function: storing the callable must not throw. "
+                      "Pass move-only callables with std::move().");
+
+        this->template store<Fd>(std::forward<F>(f), vtable_for<Fd>());
     }
 };
 
-// Non-member comparison with nullptr
-template<typename R, typename... Args, std::size_t S>
-bool operator==(const light_function<R(Args...), S>& f, std::nullptr_t) noexcept
-{
-    return !f;
-}
+// Non-owning reference to a callable, for synchronous callbacks such as
+// visitors and comparators. It is two pointers wide, never allocates and never
+// copies the callable: calls go straight through a single function pointer.
+//
+// The referenced callable must outlive the function_ref. Binding a temporary
+// lambda is fine as a function argument, since the lambda lives until the
+// call returns, but NOT when storing the function_ref for later:
+//   void for_each_sensor(function_ref<void(int)> fn);
+//   for_each_sensor([&](int id) { total += id; });   // OK
+//   function_ref<void()> r = [] { tick(); }; r();     // dangling
+//
+// Use light_function when the callback has to be stored.
+template<typename Signature>
+class function_ref;
 
-template<typename R, typename... Args, std::size_t S>
-bool operator==(std::nullptr_t, const light_function<R(Args...), S>& f) noexcept
+template<typename R, typename... Args>
+class function_ref<R(Args...)>
 {
-    return !f;
-}
+public:
+    // Binds to a callable object or a function (pointer).
+    template<
+        typename F,
+        typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, function_ref>::value &&
+                                           std::is_invocable_r<R, F&, Args...>::value>::type
+    >
+    function_ref(F&& f) noexcept
+    {
+        using Fd = typename std::decay<F>::type;
 
-template<typename R, typename... Args, std::size_t S>
-bool operator!=(const light_function<R(Args...), S>& f, std::nullptr_t) noexcept
-{
-    return !!f;
-}
+        if constexpr (std::is_pointer<Fd>::value && std::is_function<typename std::remove_pointer<Fd>::type>::value) {
+            // Functions are not objects: keep the function pointer itself.
+            // Round-tripping through another function pointer type is well defined.
+            m_target.fn = reinterpret_cast<void (*)()>(static_cast<Fd>(f));
+            m_callback = [](Target t, Args&&... args) -> R {
+                return reinterpret_cast<Fd>(t.fn)(std::forward<Args>(args)...);
+            };
+        }
+        else {
+            using Fp = typename std::remove_reference<F>::type*;
 
-template<typename R, typename... Args, std::size_t S>
-bool operator!=(std::nullptr_t, const light_function<R(Args...), S>& f) noexcept
-{
-    return !!f;
-}
+            m_target.obj = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+            m_callback = [](Target t, Args&&... args) -> R {
+                return (*static_cast<Fp>(t.obj))(std::forward<Args>(args)...);
+            };
+        }
+    }
+
+    function_ref(const function_ref&) noexcept = default;
+    function_ref& operator=(const function_ref&) noexcept = default;
+
+    // Invokes the referenced callable. Same by-value argument convention as
+    // light_function::operator().
+    R operator()(Args... args) const
+    {
+        return m_callback(m_target, std::forward<Args>(args)...);
+    }
+
+private:
+    union Target {
+        void* obj;
+        void (*fn)();
+    };
+
+    Target m_target;
+    R (*m_callback)(Target, Args&&...);
+};
 
 } // namespace lightstd
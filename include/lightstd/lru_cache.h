@@ -0,0 +1,501 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "functional.h"
+#include "unordered_map.h"
+#include <esp_err.h>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Fixed-capacity cache that evicts the least recently used entry when full.
+// Entries live in a node pool allocated once by init(). Each node embeds the prev/next links of the recency
+// list, and an open-addressed index maps keys to nodes, so get(), put() and eviction are O(1) with a single
+// lookup per hit.
+// NOTE: Pointers returned by get(), peek() and put() are invalidated once the entry is evicted or erased.
+// NOTE: lru_cache is not thread-safe; guard shared caches with a Mutex.
+template<typename K, typename V, typename HashFn = static_hash_map_default_hash<K>,
+         typename KeyEqual = static_hash_map_default_equal<K>>
+class lru_cache
+{
+private:
+    typedef struct Node_s {
+        K key;
+        V value;
+        uint32_t prev;
+        uint32_t next;
+        uint32_t hash;
+    } Node_t;
+
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    static_assert(std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>,
+                  "lru_cache requires nothrow move constructible keys and values.");
+
+public:
+    // Called with the key and value of an entry right before it is evicted. The value may be moved out.
+    typedef light_function<void(const K&, V&)> evict_callback_t;
+
+public:
+    // Creates an empty cache with no allocated storage.
+    lru_cache() noexcept = default;
+    lru_cache(const lru_cache&) = delete;
+    lru_cache(lru_cache&&) = delete;
+
+    // Destroys all entries and releases the storage.
+    ~lru_cache()
+    {
+        deinit();
+    }
+
+    lru_cache& operator=(const lru_cache&) = delete;
+    lru_cache& operator=(lru_cache&&) = delete;
+
+    // Allocates room for the requested number of entries.
+    esp_err_t init(size_t _capacity) noexcept
+    {
+        size_t _bucketCount = 4;
+
+        if (_capacity < 1 || _capacity > UINT32_MAX / 4) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        // Keep the index at most half full so probe runs stay short.
+        while (_bucketCount < _capacity * 2) {
+            _bucketCount *= 2;
+        }
+        if (_capacity > SIZE_MAX / sizeof(Node_t) || _bucketCount > SIZE_MAX / sizeof(uint32_t)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        deinit();
+
+        nodes = (Node_t *)malloc(_capacity * sizeof(Node_t));
+        buckets = (uint32_t *)malloc(_bucketCount * sizeof(uint32_t));
+        if ((!nodes) || (!buckets)) {
+            free(nodes);
+            free(buckets);
+            nodes = nullptr;
+            buckets = nullptr;
+            return ESP_ERR_NO_MEM;
+        }
+        capacityCount = (uint32_t)_capacity;
+        bucketMask = (uint32_t)(_bucketCount - 1);
+
+        memset(buckets, 0xFF, _bucketCount * sizeof(uint32_t));
+        resetNodes();
+
+        // Done
+        return ESP_OK;
+    }
+
+    // Destroys all entries, releases the storage and resets the counters.
+    void deinit() noexcept
+    {
+        if (nodes) {
+            clear();
+            free(nodes);
+            free(buckets);
+            nodes = nullptr;
+            buckets = nullptr;
+        }
+        capacityCount = 0;
+        bucketMask = 0;
+        reset_stats();
+    }
+
+    // Destroys all entries, releases the storage and resets the counters.
+    void done() noexcept
+    {
+        deinit();
+    }
+
+    // Sets the function called for each evicted entry. Pass nullptr to remove it.
+    void set_evict_callback(evict_callback_t cb) noexcept
+    {
+        onEvict = std::move(cb);
+    }
+
+    // Returns the value of a key and marks it as most recently used, or nullptr on a miss.
+    V* get(const K& key) noexcept
+    {
+        return getImpl(key);
+    }
+
+    // Looks up a key of another type, such as a C string in a string-keyed cache, without building a
+    // temporary K. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    V* get(const Q& key) noexcept
+    {
+        return getImpl(key);
+    }
+
+    // Returns the value of a key without touching its recency or the hit/miss counters.
+    V* peek(const K& key) noexcept
+    {
+        return peekImpl(key);
+    }
+
+    // Peeks a key of another type. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    V* peek(const Q& key) noexcept
+    {
+        return peekImpl(key);
+    }
+
+    // Reports whether the key is cached, without touching its recency or the counters.
+    bool contains(const K& key) noexcept
+    {
+        return findNode(key) != NIL;
+    }
+
+    // Reports whether a key of another type is cached. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool contains(const Q& key) noexcept
+    {
+        return findNode(key) != NIL;
+    }
+
+    // Inserts or updates an entry and marks it as most recently used. When the cache is full, the least
+    // recently used entry is evicted first. Returns nullptr only if the cache is not initialized.
+    V* put(const K& key, const V& value) noexcept
+    {
+        return putImpl(key, value);
+    }
+
+    // Inserts or updates an entry, moving the value in.
+    V* put(const K& key, V&& value) noexcept
+    {
+        return putImpl(key, std::move(value));
+    }
+
+    // Inserts or updates an entry, moving the key in. The key is left untouched if it already exists.
+    V* put(K&& key, const V& value) noexcept
+    {
+        return putImpl(std::move(key), value);
+    }
+
+    // Inserts or updates an entry, moving both key and value in.
+    V* put(K&& key, V&& value) noexcept
+    {
+        return putImpl(std::move(key), std::move(value));
+    }
+
+    // Removes an entry without calling the eviction callback.
+    bool erase(const K& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Removes a key of another type. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool erase(const Q& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Evicts the least recently used entry, calling the eviction callback. Returns false if the cache is empty.
+    bool evict() noexcept
+    {
+        if (tail == NIL) {
+            return false;
+        }
+        evictTail();
+        return true;
+    }
+
+    // Returns the number of cached entries.
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    // Returns the maximum number of entries.
+    size_t capacity() const noexcept
+    {
+        return capacityCount;
+    }
+
+    // Reports whether the cache contains no entries.
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    // Destroys all entries without calling the eviction callback. Counters are kept.
+    void clear() noexcept
+    {
+        if (!nodes) {
+            return;
+        }
+        for (uint32_t n = head; n != NIL; n = nodes[n].next) {
+            nodes[n].key.~K();
+            nodes[n].value.~V();
+        }
+        memset(buckets, 0xFF, ((size_t)bucketMask + 1) * sizeof(uint32_t));
+        resetNodes();
+    }
+
+    // Returns the number of get() calls that found their key.
+    uint32_t hit_count() const noexcept
+    {
+        return hits;
+    }
+
+    // Returns the number of get() calls that missed.
+    uint32_t miss_count() const noexcept
+    {
+        return misses;
+    }
+
+    // Returns the number of entries evicted to make room or by evict().
+    uint32_t eviction_count() const noexcept
+    {
+        return evictions;
+    }
+
+    // Resets the hit, miss and eviction counters.
+    void reset_stats() noexcept
+    {
+        hits = 0;
+        misses = 0;
+        evictions = 0;
+    }
+
+    // Runs fn(const K&, V&) on every entry, from the most to the least recently used, without touching recency.
+    template <class Fn>
+    void for_each(Fn&& fn) noexcept
+    {
+        for (uint32_t n = head; n != NIL; n = nodes[n].next) {
+            fn(static_cast<const K&>(nodes[n].key), nodes[n].value);
+        }
+    }
+
+private:
+    template <class KArg, class VArg>
+    V* putImpl(KArg&& key, VArg&& value) noexcept
+    {
+        uint32_t hash, bucket, n;
+
+        if (!nodes) {
+            return nullptr;
+        }
+
+        hash = hasher(key);
+        bucket = findBucket(key, hash);
+        if (buckets[bucket] != NIL) {
+            n = buckets[bucket];
+            nodes[n].value = std::forward<VArg>(value); // Update existing
+            moveToFront(n);
+            return &nodes[n].value;
+        }
+
+        if (count == capacityCount) {
+            if (isInNodes(&key) || isInNodes(&value)) {
+                // The arguments reference an entry that may be the one evicted.
+                K keyCopy(std::forward<KArg>(key));
+                V valueCopy(std::forward<VArg>(value));
+
+                return putImpl(std::move(keyCopy), std::move(valueCopy));
+            }
+            evictTail();
+            // Removing the evicted entry may have shifted our bucket.
+            bucket = findBucket(key, hash);
+        }
+
+        n = freeHead;
+        freeHead = nodes[n].next;
+        ::new (static_cast<void*>(&nodes[n].key)) K(std::forward<KArg>(key));
+        ::new (static_cast<void*>(&nodes[n].value)) V(std::forward<VArg>(value));
+        nodes[n].hash = hash;
+        buckets[bucket] = n;
+        linkFront(n);
+        count += 1;
+        return &nodes[n].value;
+    }
+
+    bool isInNodes(const void *p) const noexcept
+    {
+        return p >= static_cast<const void*>(nodes) && p < static_cast<const void*>(nodes + capacityCount);
+    }
+
+    template <class Q>
+    V* getImpl(const Q& key) noexcept
+    {
+        uint32_t n = findNode(key);
+
+        if (n == NIL) {
+            misses += 1;
+            return nullptr;
+        }
+        hits += 1;
+        moveToFront(n);
+        return &nodes[n].value;
+    }
+
+    template <class Q>
+    V* peekImpl(const Q& key) noexcept
+    {
+        uint32_t n = findNode(key);
+
+        return (n != NIL) ? &nodes[n].value : nullptr;
+    }
+
+    template <class Q>
+    bool eraseImpl(const Q& key) noexcept
+    {
+        uint32_t bucket;
+
+        if (!nodes) {
+            return false;
+        }
+        bucket = findBucket(key, hasher(key));
+        if (buckets[bucket] == NIL) {
+            return false;
+        }
+        removeNode(buckets[bucket], bucket);
+        return true;
+    }
+
+    template <class Q>
+    uint32_t findNode(const Q& key) const noexcept
+    {
+        if (!nodes) {
+            return NIL;
+        }
+        return buckets[findBucket(key, hasher(key))];
+    }
+
+    // Returns the bucket pointing to key, or the empty bucket ending its probe run.
+    template <class Q>
+    uint32_t findBucket(const Q& key, uint32_t hash) const noexcept
+    {
+        uint32_t idx = hash & bucketMask;
+
+        while (buckets[idx] != NIL) {
+            const Node_t &node = nodes[buckets[idx]];
+
+            if (node.hash == hash && keyEqual(node.key, key)) {
+                break;
+            }
+            idx = (idx + 1) & bucketMask;
+        }
+        return idx;
+    }
+
+    void evictTail() noexcept
+    {
+        uint32_t n = tail;
+
+        if (onEvict) {
+            onEvict(static_cast<const K&>(nodes[n].key), nodes[n].value);
+        }
+        removeNode(n, findBucket(nodes[n].key, nodes[n].hash));
+        evictions += 1;
+    }
+
+    // Unlinks and destroys a node, returning it to the free list.
+    void removeNode(uint32_t n, uint32_t bucket) noexcept
+    {
+        uint32_t idx = bucket;
+
+        // Backward-shift deletion keeps probe runs intact without tombstones.
+        buckets[bucket] = NIL;
+        for (;;) {
+            idx = (idx + 1) & bucketMask;
+            if (buckets[idx] == NIL) {
+                break;
+            }
+
+            uint32_t home = nodes[buckets[idx]].hash & bucketMask;
+            if (((idx - home) & bucketMask) >= ((idx - bucket) & bucketMask)) {
+                buckets[bucket] = buckets[idx];
+                buckets[idx] = NIL;
+                bucket = idx;
+            }
+        }
+
+        unlink(n);
+        nodes[n].key.~K();
+        nodes[n].value.~V();
+        nodes[n].next = freeHead;
+        freeHead = n;
+        count -= 1;
+    }
+
+    void linkFront(uint32_t n) noexcept
+    {
+        nodes[n].prev = NIL;
+        nodes[n].next = head;
+        if (head != NIL) {
+            nodes[head].prev = n;
+        }
+        else {
+            tail = n;
+        }
+        head = n;
+    }
+
+    void unlink(uint32_t n) noexcept
+    {
+        if (nodes[n].prev != NIL) {
+            nodes[nodes[n].prev].next = nodes[n].next;
+        }
+        else {
+            head = nodes[n].next;
+        }
+        if (nodes[n].next != NIL) {
+            nodes[nodes[n].next].prev = nodes[n].prev;
+        }
+        else {
+            tail = nodes[n].prev;
+        }
+    }
+
+    void moveToFront(uint32_t n) noexcept
+    {
+        if (head != n) {
+            unlink(n);
+            linkFront(n);
+        }
+    }
+
+    // Puts every node on the free list.
+    void resetNodes() noexcept
+    {
+        for (uint32_t i = 0; i < capacityCount; i++) {
+            nodes[i].next = (i + 1 < capacityCount) ? i + 1 : NIL;
+        }
+        freeHead = 0;
+        head = NIL;
+        tail = NIL;
+        count = 0;
+    }
+
+private:
+    HashFn hasher;
+    KeyEqual keyEqual;
+    evict_callback_t onEvict;
+    Node_t *nodes{nullptr};
+    uint32_t *buckets{nullptr};
+    uint32_t bucketMask{0};
+    uint32_t capacityCount{0};
+    uint32_t count{0};
+    uint32_t head{NIL};
+    uint32_t tail{NIL};
+    uint32_t freeHead{NIL};
+    uint32_t hits{0};
+    uint32_t misses{0};
+    uint32_t evictions{0};
+};
+
+} // namespace lightstd
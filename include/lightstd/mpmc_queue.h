@@ -0,0 +1,392 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "allocator.h"
+#include "cache_line.h"
+#include "mutex.h"
+#include <esp_err.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <stdatomic.h>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Bounded multi-producer/multi-consumer queue (Dmitry Vyukov's design) for handing work items between tasks
+// on both cores. Every slot carries an atomic sequence number telling whether it is ready to be written or
+// read in the current lap, so a push or pop is one CAS on the shared position plus one release store on the
+// slot, with no critical section. Items are moved in and out, so move-only types such as unique_function
+// can be queued.
+// try_push() and try_pop() never block. push() and pop() spin through the lock-free path first and only
+// park the calling task on its notification value when the queue is full or empty; the other side then
+// wakes one parked task. The waiter list is guarded by a mutex that is only taken when someone is parked.
+// NOTE: The capacity is rounded up to a power of two, at least 2.
+// NOTE: push() and pop() use the calling task's notification value (index 0); do not wait on it for other
+//       purposes in the same task while blocked here. None of the methods may be called from an ISR.
+template <class T>
+class mpmc_queue
+{
+    static_assert(std::is_nothrow_move_constructible_v<T>, "mpmc_queue: T must be nothrow move constructible.");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "mpmc_queue: T is over-aligned.");
+
+public:
+    static constexpr size_t MAX_CAPACITY = (size_t)1 << 30;
+    // Times push() and pop() yield and retry before parking.
+    static constexpr uint32_t SPIN_YIELDS = 8;
+
+    // Creates an empty queue using the provided allocator or the default one. Call init() before use.
+    mpmc_queue(IAllocator *_alloc = nullptr) noexcept
+    {
+        alloc = _alloc ? _alloc : IAllocator::getDefault();
+        atomic_init(&enqueuePos, 0u);
+        atomic_init(&dequeuePos, 0u);
+        atomic_init(&notFull.count, 0u);
+        atomic_init(&notEmpty.count, 0u);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue(mpmc_queue&&) = delete;
+
+    // Destroys the queued items and releases the storage.
+    ~mpmc_queue() noexcept
+    {
+        deinit();
+    }
+
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(mpmc_queue&&) = delete;
+
+    // Allocates room for at least minCapacity items. Call it before any task uses the queue.
+    esp_err_t init(size_t minCapacity) noexcept
+    {
+        size_t newCapacity = 2;
+
+        if (minCapacity < 1 || minCapacity > MAX_CAPACITY) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        while (newCapacity < minCapacity) {
+            newCapacity <<= 1;
+        }
+        // Rounding up may double the request, so check the size actually allocated.
+        if (newCapacity > SIZE_MAX / sizeof(Cell)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        deinit();
+        cells = static_cast<Cell*>(alloc->allocate(newCapacity * sizeof(Cell)));
+        if (!cells) {
+            return ESP_ERR_NO_MEM;
+        }
+        for (size_t i = 0; i < newCapacity; i++) {
+            ::new (&cells[i]) Cell();
+            atomic_store_explicit(&cells[i].sequence, (uint32_t)i, memory_order_relaxed);
+        }
+        mask = (uint32_t)(newCapacity - 1);
+
+        // Done
+        return ESP_OK;
+    }
+
+    // Destroys the queued items and releases the storage. No task may be using the queue.
+    void deinit() noexcept
+    {
+        if (cells) {
+            uint32_t pos = atomic_load_explicit(&dequeuePos, memory_order_relaxed);
+            uint32_t end = atomic_load_explicit(&enqueuePos, memory_order_relaxed);
+
+            for (; pos != end; pos++) {
+                cells[pos & mask].item()->~T();
+            }
+            for (size_t i = 0; i <= mask; i++) {
+                cells[i].~Cell();
+            }
+            alloc->deallocate(cells);
+            cells = nullptr;
+        }
+        mask = 0;
+        atomic_store_explicit(&enqueuePos, 0u, memory_order_relaxed);
+        atomic_store_explicit(&dequeuePos, 0u, memory_order_relaxed);
+    }
+
+    // Returns the number of items the queue holds when full.
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return cells ? (size_t)mask + 1 : 0;
+    }
+
+    // Returns the number of queued items. Only a snapshot while other tasks are pushing or popping.
+    [[nodiscard]] size_t size_approx() const noexcept
+    {
+        uint32_t head = atomic_load_explicit(&dequeuePos, memory_order_relaxed);
+        int32_t diff = (int32_t)(atomic_load_explicit(&enqueuePos, memory_order_relaxed) - head);
+
+        return (diff > 0) ? (size_t)diff : 0;
+    }
+
+    // Constructs an item in place at the back. Returns false if the queue is full.
+    template <class... Args>
+    bool try_emplace(Args&&... args) noexcept
+    {
+        static_assert(std::is_nothrow_constructible_v<T, Args&&...>, "mpmc_queue: constructing T must not throw.");
+        Cell *cell = claim<true>();
+
+        if (!cell) {
+            return false;
+        }
+        ::new (cell->storage) T(std::forward<Args>(args)...);
+        publish<true>(cell);
+        return true;
+    }
+
+    // Copies an item to the back. Returns false if the queue is full.
+    bool try_push(const T& item) noexcept
+    {
+        return try_emplace(item);
+    }
+
+    // Moves an item to the back. Returns false if the queue is full.
+    bool try_push(T&& item) noexcept
+    {
+        return try_emplace(std::move(item));
+    }
+
+    // Moves the front item into out. Returns false if the queue is empty.
+    bool try_pop(T& out) noexcept
+    {
+        Cell *cell = claim<false>();
+
+        if (!cell) {
+            return false;
+        }
+        out = std::move(*cell->item());
+        cell->item()->~T();
+        publish<false>(cell);
+        return true;
+    }
+
+    // Copies an item to the back, waiting up to wait ticks for room. Returns false on timeout.
+    bool push(const T& item, TickType_t wait = portMAX_DELAY) noexcept
+    {
+        return waitFor(notFull, wait, [&]() {
+            return try_emplace(item);
+        });
+    }
+
+    // Moves an item to the back, waiting up to wait ticks for room. Returns false on timeout, in which case
+    // item is left untouched.
+    bool push(T&& item, TickType_t wait = portMAX_DELAY) noexcept
+    {
+        return waitFor(notFull, wait, [&]() {
+            return try_emplace(std::move(item));
+        });
+    }
+
+    // Moves the front item into out, waiting up to wait ticks for one. Returns false on timeout.
+    bool pop(T& out, TickType_t wait = portMAX_DELAY) noexcept
+    {
+        return waitFor(notEmpty, wait, [&]() {
+            return try_pop(out);
+        });
+    }
+
+private:
+    struct Cell
+    {
+        _Atomic(uint32_t) sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* item() noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    // A task parked in push() or pop(). Lives on that task's stack.
+    struct Waiter
+    {
+        TaskHandle_t task;
+        Waiter *next;
+        bool notified;
+    };
+
+    struct WaitList
+    {
+        _Atomic(uint32_t) count;
+        Waiter *head{nullptr};
+    };
+
+    // Reserves the next slot to write (Push) or read. A slot is writable in lap N when its sequence equals
+    // the position, and readable once the writer bumped it to position + 1. Returns null if full or empty.
+    template <bool Push>
+    Cell* claim() noexcept
+    {
+        _Atomic(uint32_t) *position = Push ? &enqueuePos : &dequeuePos;
+        uint32_t pos = atomic_load_explicit(position, memory_order_relaxed);
+
+        if (!cells) {
+            return nullptr;
+        }
+        for (;;) {
+            Cell *cell = &cells[pos & mask];
+            uint32_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+            int32_t diff = (int32_t)(seq - (Push ? pos : pos + 1));
+
+            if (diff == 0) {
+                // The slot is ours if no other producer (consumer) moved the position meanwhile.
+                if (atomic_compare_exchange_weak_explicit(position, &pos, pos + 1, memory_order_relaxed,
+                                                          memory_order_relaxed)) {
+                    return cell;
+                }
+            }
+            else if (diff < 0) {
+                // The slot still holds last lap's item (full) or has not been written yet (empty).
+                return nullptr;
+            }
+            else {
+                // Another task already took this position; catch up.
+                pos = atomic_load_explicit(position, memory_order_relaxed);
+            }
+        }
+    }
+
+    // Hands a claimed slot to the other side and wakes one of its parked tasks, if any.
+    template <bool Push>
+    void publish(Cell *cell) noexcept
+    {
+        uint32_t seq = atomic_load_explicit(&cell->sequence, memory_order_relaxed);
+
+        // After a push the slot becomes readable at pos + 1; after a pop it becomes writable for the next
+        // lap at pos + capacity.
+        atomic_store_explicit(&cell->sequence, Push ? seq + 1 : seq + mask, memory_order_release);
+        wakeOne(Push ? notEmpty : notFull);
+    }
+
+    void wakeOne(WaitList& list) noexcept
+    {
+        // Pairs with the fence in waitFor(): either the parked task's retry sees our update or we see its
+        // registration here.
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&list.count, memory_order_relaxed) == 0) {
+            return;
+        }
+
+        AutoMutex lock(waitMtx);
+        Waiter *waiter = list.head;
+
+        if (waiter) {
+            // Notify under the lock so a waiter that finds itself removed knows the notification is pending.
+            list.head = waiter->next;
+            atomic_fetch_sub_explicit(&list.count, 1u, memory_order_relaxed);
+            waiter->notified = true;
+            xTaskNotifyGive(waiter->task);
+        }
+    }
+
+    template <class TryOp>
+    bool waitFor(WaitList& list, TickType_t wait, TryOp&& tryOp) noexcept
+    {
+        TickType_t start, remaining = wait;
+        Waiter self;
+
+        if (tryOp()) {
+            return true;
+        }
+        if (wait == 0 || !cells) {
+            return false;
+        }
+
+        // The other side is usually only a few instructions away from freeing a slot, so yield a few times
+        // before paying for the mutex and a notification round trip.
+        for (uint32_t spin = 0; spin < SPIN_YIELDS; spin++) {
+            taskYIELD();
+            if (tryOp()) {
+                return true;
+            }
+        }
+
+        self.task = xTaskGetCurrentTaskHandle();
+        start = xTaskGetTickCount();
+        for (;;) {
+            bool done;
+
+            {
+                AutoMutex lock(waitMtx);
+
+                self.next = list.head;
+                self.notified = false;
+                list.head = &self;
+                atomic_fetch_add_explicit(&list.count, 1u, memory_order_relaxed);
+            }
+            atomic_thread_fence(memory_order_seq_cst);
+
+            // Retry after registering so an update that raced with the registration is not missed.
+            done = tryOp();
+            if (!done) {
+                ulTaskNotifyTake(pdTRUE, remaining);
+            }
+            removeWaiter(list, &self);
+            if (done || tryOp()) {
+                return true;
+            }
+
+            if (wait != portMAX_DELAY) {
+                TickType_t elapsed = xTaskGetTickCount() - start;
+
+                if (elapsed >= wait) {
+                    return false;
+                }
+                remaining = wait - elapsed;
+            }
+        }
+    }
+
+    // Unlinks a waiter that was not woken. One that was woken may still have its notification pending,
+    // e.g. if it timed out at the same time, so clear it to avoid a spurious wake-up on the next wait.
+    void removeWaiter(WaitList& list, Waiter *self) noexcept
+    {
+        bool notified;
+
+        {
+            AutoMutex lock(waitMtx);
+
+            notified = self->notified;
+            if (!notified) {
+                Waiter **link = &list.head;
+
+                while (*link != self) {
+                    link = &(*link)->next;
+                }
+                *link = self->next;
+                atomic_fetch_sub_explicit(&list.count, 1u, memory_order_relaxed);
+            }
+        }
+        if (notified) {
+            ulTaskNotifyTake(pdTRUE, 0);
+        }
+    }
+
+private:
+    alignas(LIGHTSTD_CACHE_LINE_SIZE) _Atomic(uint32_t) enqueuePos;
+    alignas(LIGHTSTD_CACHE_LINE_SIZE) _Atomic(uint32_t) dequeuePos;
+
+    // Read-only after init().
+    alignas(LIGHTSTD_CACHE_LINE_SIZE) Cell *cells{nullptr};
+    uint32_t mask{0};
+    IAllocator *alloc{nullptr};
+
+    // Slow path, only touched when a task parks or one is parked.
+    Mutex waitMtx;
+    WaitList notFull;
+    WaitList notEmpty;
+};
+
+} // namespace lightstd
@@ -0,0 +1,31 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "vector.h"
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Vector with the same API as lightstd::vector that keeps up to N elements inside the object
+// and only uses the allocator once the collection outgrows them.
+// NOTE: lightstd::small_vector does NOT throw exceptions on purpose.
+template <class T, size_t N, class GrowthPolicy = growth_policy_double<>>
+class small_vector final : public detail::basic_vector<T, N, GrowthPolicy>
+{
+    static_assert(N > 0, "small_vector: N must be at least 1, use lightstd::vector instead.");
+
+public:
+    using detail::basic_vector<T, N, GrowthPolicy>::basic_vector;
+
+    // Reports whether the elements are currently stored in the inline buffer.
+    [[nodiscard]] bool is_inline() const noexcept
+    {
+        return this->capacity() == N;
+    }
+};
+
+} // namespace lightstd
@@ -0,0 +1,210 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+struct GrowableBuffer_s;
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+template <class T>
+class span;
+
+namespace detail {
+
+template <class T>
+struct is_span : std::false_type {};
+
+template <class T>
+struct is_span<span<T>> : std::true_type {};
+
+} // namespace detail
+
+// Non-owning view over a contiguous range of elements. It never allocates and is cheap to pass by value.
+// Any container exposing data() and size() (vector, small_vector, static_vector, ...) converts implicitly,
+// as does a GrowableBuffer_t for byte spans.
+template <class T>
+class span
+{
+public:
+    using element_type    = T;
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    static constexpr size_t npos = (size_t)-1;
+
+    // Creates an empty span.
+    constexpr span() noexcept = default;
+    // Creates a span over count elements starting at _ptr.
+    constexpr span(T* _ptr, size_t count) noexcept : ptr(_ptr), len(count)
+    {
+    }
+    // Creates a span over the range [first, last).
+    constexpr span(T* first, T* last) noexcept : ptr(first), len(static_cast<size_t>(last - first))
+    {
+    }
+    // Creates a span over a C array.
+    template <size_t N>
+    constexpr span(T (&arr)[N]) noexcept : ptr(arr), len(N)
+    {
+    }
+    // Creates a span from another span with a compatible (e.g. less qualified) element type.
+    template <class U, typename = std::enable_if_t<std::is_convertible_v<U(*)[], T(*)[]>>>
+    constexpr span(const span<U>& other) noexcept : ptr(other.data()), len(other.size())
+    {
+    }
+    // Creates a span over a contiguous container exposing data() and size().
+    template <class C, typename = std::enable_if_t<!detail::is_span<std::remove_cv_t<C>>::value &&
+                                                   std::is_convertible_v<decltype(std::declval<C&>().data()), T*> &&
+                                                   std::is_convertible_v<decltype(std::declval<C&>().size()), size_t>>>
+    constexpr span(C& container) noexcept : ptr(container.data()), len(container.size())
+    {
+    }
+    // Creates a byte span over the used part of a growable buffer.
+    template <class G, std::enable_if_t<std::is_same_v<std::remove_cv_t<G>, GrowableBuffer_s> &&
+                                        std::is_convertible_v<uint8_t(*)[], T(*)[]>, int> = 0>
+    span(G& gb) noexcept : ptr(gb.buffer), len(gb.used)
+    {
+    }
+
+    constexpr span(const span&) noexcept = default;
+    constexpr span& operator=(const span&) noexcept = default;
+
+    // Returns the number of elements in the view.
+    [[nodiscard]] constexpr size_t size() const noexcept
+    {
+        return len;
+    }
+
+    // Returns the size of the view in bytes.
+    [[nodiscard]] constexpr size_t size_bytes() const noexcept
+    {
+        return len * sizeof(T);
+    }
+
+    // Reports whether the view contains no elements.
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return len == 0;
+    }
+
+    // Returns a pointer to the first element.
+    constexpr T* data() const noexcept
+    {
+        return ptr;
+    }
+
+    // Returns an iterator to the first element.
+    constexpr iterator begin() const noexcept
+    {
+        return ptr;
+    }
+
+    // Returns an iterator one past the last element.
+    constexpr iterator end() const noexcept
+    {
+        return ptr + len;
+    }
+
+    // Returns a reference to the element at the requested index.
+    [[nodiscard]] constexpr T& operator[](size_t idx) const noexcept
+    {
+        assert(idx < len);
+        return ptr[idx]; // WARNING: no bounds check
+    }
+
+    // Returns a reference to the first element.
+    [[nodiscard]] constexpr T& front() const noexcept
+    {
+        assert(len > 0);
+        return ptr[0];
+    }
+
+    // Returns a reference to the last element.
+    [[nodiscard]] constexpr T& back() const noexcept
+    {
+        assert(len > 0);
+        return ptr[len - 1];
+    }
+
+    // Returns a view of the first count elements.
+    [[nodiscard]] constexpr span first(size_t count) const noexcept
+    {
+        assert(count <= len);
+        return span(ptr, count);
+    }
+
+    // Returns a view of the last count elements.
+    [[nodiscard]] constexpr span last(size_t count) const noexcept
+    {
+        assert(count <= len);
+        return span(ptr + (len - count), count);
+    }
+
+    // Returns a view of count elements starting at offset, or up to the end if count is npos.
+    // Out of range requests are clamped to the available elements.
+    [[nodiscard]] constexpr span subspan(size_t offset, size_t count = npos) const noexcept
+    {
+        if (offset > len) {
+            offset = len;
+        }
+        if (count > len - offset) {
+            count = len - offset;
+        }
+        return span(ptr + offset, count);
+    }
+
+private:
+    T* ptr{nullptr};
+    size_t len{0};
+};
+
+// Reinterprets a span as a read-only byte view.
+template <class T>
+span<const uint8_t> as_bytes(span<T> s) noexcept
+{
+    return span<const uint8_t>(reinterpret_cast<const uint8_t*>(s.data()), s.size_bytes());
+}
+
+// Compares two spans element by element.
+template <class T, class U>
+bool operator==(span<T> a, span<U> b) noexcept
+{
+    static_assert(std::is_same_v<std::remove_cv_t<T>, std::remove_cv_t<U>>, "span: comparing views of different element types.");
+
+    if (a.size() != b.size()) {
+        return false;
+    }
+    if (a.data() == b.data()) {
+        return true;
+    }
+    if constexpr (std::is_integral_v<std::remove_cv_t<T>> || std::is_pointer_v<std::remove_cv_t<T>>) {
+        return memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+    }
+    else {
+        for (size_t i = 0; i < a.size(); i++) {
+            if (!(a[i] == b[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+template <class T, class U>
+bool operator!=(span<T> a, span<U> b) noexcept
+{
+    return !(a == b);
+}
+
+} // namespace lightstd
@@ -0,0 +1,308 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "allocator.h"
+#include "cache_line.h"
+#include "span.h"
+#include <assert.h>
+#include <esp_err.h>
+#include <stdatomic.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Lock-free ring buffer for exactly one producer and one consumer, e.g. a UART or sensor ISR feeding a
+// processing task. Items are copied in bulk with at most two memcpy calls, and write_span()/read_span()
+// expose the free and filled regions directly so a DMA transfer or parser can work in place.
+// The capacity is rounded up to a power of two. The indexes run freely and are masked on access, so every
+// slot is usable and no "one slot empty" rule applies.
+// Each side keeps a private copy of the other side's index and only reloads it when that copy says the
+// buffer is full (producer) or empty (consumer), which keeps cross-core traffic to one line per refill.
+// NOTE: Producer methods (push, write, write_span, commit_write) must only be called from one task or ISR,
+//       and consumer methods (pop, read, read_span, consume) from one other. Neither side takes a lock or
+//       allocates, so either may run in an ISR, but the code is not placed in IRAM: do not use it from
+//       interrupts registered with ESP_INTR_FLAG_IRAM.
+// NOTE: For zero-copy DMA, pass an allocator that returns DMA-capable memory.
+template <class T = uint8_t>
+class spsc_ring_buffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "spsc_ring_buffer: T must be trivially copyable.");
+
+public:
+    static constexpr size_t MAX_CAPACITY = (size_t)1 << 31;
+
+    // Creates an empty ring buffer using the provided allocator or the default one. Call init() before use.
+    spsc_ring_buffer(IAllocator *_alloc = nullptr) noexcept
+    {
+        alloc = _alloc ? _alloc : IAllocator::getDefault();
+        atomic_init(&head, 0u);
+        atomic_init(&tail, 0u);
+    }
+
+    spsc_ring_buffer(const spsc_ring_buffer&) = delete;
+    spsc_ring_buffer(spsc_ring_buffer&&) = delete;
+
+    // Releases the storage.
+    ~spsc_ring_buffer() noexcept
+    {
+        deinit();
+    }
+
+    spsc_ring_buffer& operator=(const spsc_ring_buffer&) = delete;
+    spsc_ring_buffer& operator=(spsc_ring_buffer&&) = delete;
+
+    // Allocates room for at least minCapacity items, rounded up to a power of two. Call it before the
+    // producer and consumer start.
+    esp_err_t init(size_t minCapacity) noexcept
+    {
+        size_t newCapacity = 1;
+
+        if (minCapacity < 1 || minCapacity > MAX_CAPACITY) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        while (newCapacity < minCapacity) {
+            newCapacity <<= 1;
+        }
+        // Rounding up may double the request, so check the size actually allocated.
+        if (newCapacity > SIZE_MAX / sizeof(T)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        deinit();
+        items = static_cast<T*>(alloc->allocate(newCapacity * sizeof(T)));
+        if (!items) {
+            return ESP_ERR_NO_MEM;
+        }
+        mask = (uint32_t)(newCapacity - 1);
+
+        // Done
+        return ESP_OK;
+    }
+
+    // Releases the storage. The producer and consumer must be stopped.
+    void deinit() noexcept
+    {
+        if (items) {
+            alloc->deallocate(items);
+            items = nullptr;
+        }
+        mask = 0;
+        atomic_store_explicit(&head, 0u, memory_order_relaxed);
+        atomic_store_explicit(&tail, 0u, memory_order_relaxed);
+        cachedHead = 0;
+        cachedTail = 0;
+    }
+
+    // Returns the number of items the buffer holds when full.
+    [[nodiscard]] size_t capacity() const noexcept
+    {
+        return items ? (size_t)mask + 1 : 0;
+    }
+
+    // Returns the number of buffered items. Only a snapshot when the other side is running.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        uint32_t h = atomic_load_explicit(&head, memory_order_acquire);
+
+        return (size_t)(atomic_load_explicit(&tail, memory_order_acquire) - h);
+    }
+
+    // Reports whether the buffer holds no items.
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+    // Returns the number of items that can be written right now.
+    [[nodiscard]] size_t free_space() const noexcept
+    {
+        return capacity() - size();
+    }
+
+    // Producer: appends one item. Returns false if the buffer is full.
+    bool push(const T& item) noexcept
+    {
+        uint32_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+
+        if (t - cachedHead > mask || !items) {
+            cachedHead = atomic_load_explicit(&head, memory_order_acquire);
+            if (t - cachedHead > mask || !items) {
+                return false;
+            }
+        }
+        items[t & mask] = item;
+        atomic_store_explicit(&tail, t + 1, memory_order_release);
+        return true;
+    }
+
+    // Producer: appends up to count items and returns how many fit.
+    size_t write(const T *src, size_t count) noexcept
+    {
+        uint32_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+        size_t avail = producerFree(t, count);
+
+        if (count > avail) {
+            count = avail;
+        }
+        if (count > 0) {
+            copyIn(t, src, count);
+            atomic_store_explicit(&tail, t + (uint32_t)count, memory_order_release);
+        }
+        return count;
+    }
+
+    // Producer: returns the largest contiguous free region. It may be shorter than free_space() when the
+    // free space wraps around the end of the storage. Fill it, then publish the items with commit_write().
+    [[nodiscard]] span<T> write_span() noexcept
+    {
+        uint32_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+        size_t avail = producerFree(t, SIZE_MAX);
+        size_t toEnd = (size_t)mask + 1 - (t & mask);
+
+        if (!items) {
+            return span<T>();
+        }
+        return span<T>(items + (t & mask), (avail < toEnd) ? avail : toEnd);
+    }
+
+    // Producer: publishes count items written into the region returned by write_span().
+    void commit_write(size_t count) noexcept
+    {
+        uint32_t t = atomic_load_explicit(&tail, memory_order_relaxed);
+
+        assert(count <= (size_t)mask + 1 - (size_t)(t - cachedHead));
+        atomic_store_explicit(&tail, t + (uint32_t)count, memory_order_release);
+    }
+
+    // Consumer: removes the oldest item. Returns false if the buffer is empty.
+    bool pop(T& item) noexcept
+    {
+        uint32_t h = atomic_load_explicit(&head, memory_order_relaxed);
+
+        if (cachedTail == h) {
+            cachedTail = atomic_load_explicit(&tail, memory_order_acquire);
+            if (cachedTail == h) {
+                return false;
+            }
+        }
+        item = items[h & mask];
+        atomic_store_explicit(&head, h + 1, memory_order_release);
+        return true;
+    }
+
+    // Consumer: removes up to count items into dest and returns how many were read.
+    size_t read(T *dest, size_t count) noexcept
+    {
+        uint32_t h = atomic_load_explicit(&head, memory_order_relaxed);
+        size_t avail = consumerAvailable(h, count);
+
+        if (count > avail) {
+            count = avail;
+        }
+        if (count > 0) {
+            copyOut(h, dest, count);
+            atomic_store_explicit(&head, h + (uint32_t)count, memory_order_release);
+        }
+        return count;
+    }
+
+    // Consumer: returns the largest contiguous run of buffered items, oldest first. It may be shorter than
+    // size() when the data wraps around. Process it in place, then release it with consume().
+    [[nodiscard]] span<const T> read_span() noexcept
+    {
+        uint32_t h = atomic_load_explicit(&head, memory_order_relaxed);
+        size_t avail = consumerAvailable(h, SIZE_MAX);
+        size_t toEnd = (size_t)mask + 1 - (h & mask);
+
+        if (!items) {
+            return span<const T>();
+        }
+        return span<const T>(items + (h & mask), (avail < toEnd) ? avail : toEnd);
+    }
+
+    // Consumer: drops the count oldest items, e.g. after handling the region returned by read_span().
+    void consume(size_t count) noexcept
+    {
+        uint32_t h = atomic_load_explicit(&head, memory_order_relaxed);
+
+        assert(count <= (size_t)(cachedTail - h));
+        atomic_store_explicit(&head, h + (uint32_t)count, memory_order_release);
+    }
+
+private:
+    // Free slots seen by the producer. Reloads the consumer index only if the cached one cannot satisfy wanted.
+    size_t producerFree(uint32_t t, size_t wanted) noexcept
+    {
+        size_t avail = (size_t)mask + 1 - (size_t)(t - cachedHead);
+
+        if (avail < wanted) {
+            cachedHead = atomic_load_explicit(&head, memory_order_acquire);
+            avail = (size_t)mask + 1 - (size_t)(t - cachedHead);
+        }
+        return items ? avail : 0;
+    }
+
+    // Filled slots seen by the consumer. Reloads the producer index only if the cached one cannot satisfy wanted.
+    size_t consumerAvailable(uint32_t h, size_t wanted) noexcept
+    {
+        size_t avail = (size_t)(cachedTail - h);
+
+        if (avail < wanted) {
+            cachedTail = atomic_load_explicit(&tail, memory_order_acquire);
+            avail = (size_t)(cachedTail - h);
+        }
+        return avail;
+    }
+
+    void copyIn(uint32_t t, const T *src, size_t count) noexcept
+    {
+        size_t offset = t & mask;
+        size_t first = (size_t)mask + 1 - offset;
+
+        if (first > count) {
+            first = count;
+        }
+        memcpy(items + offset, src, first * sizeof(T));
+        if (count > first) {
+            memcpy(items, src + first, (count - first) * sizeof(T));
+        }
+    }
+
+    void copyOut(uint32_t h, T *dest, size_t count) const noexcept
+    {
+        size_t offset = h & mask;
+        size_t first = (size_t)mask + 1 - offset;
+
+        if (first > count) {
+            first = count;
+        }
+        memcpy(dest, items + offset, first * sizeof(T));
+        if (count > first) {
+            memcpy(dest + first, items, (count - first) * sizeof(T));
+        }
+    }
+
+private:
+    // Consumer-owned line: its index and its view of the producer's.
+    alignas(LIGHTSTD_CACHE_LINE_SIZE) _Atomic(uint32_t) head;
+    uint32_t cachedTail{0};
+
+    // Producer-owned line.
+    alignas(LIGHTSTD_CACHE_LINE_SIZE) _Atomic(uint32_t) tail;
+    uint32_t cachedHead{0};
+
+    // Read-only after init().
+    alignas(LIGHTSTD_CACHE_LINE_SIZE) T *items{nullptr};
+    uint32_t mask{0};
+    IAllocator *alloc{nullptr};
+};
+
+} // namespace lightstd
@@ -0,0 +1,458 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "vector.h"
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Fixed-capacity vector with the same API as lightstd::vector that keeps all of its storage
+// inside the object and never allocates. Operations that would exceed N return false.
+// It can be constant-initialized, so a global static_vector is usable before the heap is up.
+// NOTE: lightstd::static_vector does NOT throw exceptions on purpose.
+template <class T, size_t N>
+class static_vector final
+{
+    static_assert(N > 0, "static_vector: N must be at least 1.");
+
+public:
+    using iterator        = T*;
+    using const_iterator  = const T*;
+
+    // Creates an empty vector.
+    constexpr static_vector() noexcept : unused(), len(0)
+    {
+    }
+
+    static_vector(const static_vector&) noexcept = delete;
+    // Moves the elements of other into this vector.
+    static_vector(static_vector&& other) noexcept : len(0)
+    {
+        take_from(other);
+    }
+
+    static_vector& operator=(const static_vector&) noexcept = delete;
+    static_vector& operator=(static_vector&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            take_from(other);
+        }
+        return *this;
+    }
+
+    // Destroys live elements.
+    ~static_vector() noexcept
+    {
+        clear();
+    }
+
+    // Returns the number of constructed elements.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return len;
+    }
+    // Returns the fixed element capacity.
+    [[nodiscard]] static constexpr size_t capacity() noexcept
+    {
+        return N;
+    }
+    // Reports whether the vector contains no elements.
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return len == 0;
+    }
+    // Reports whether the vector cannot accept more elements.
+    [[nodiscard]] bool full() const noexcept
+    {
+        return len == N;
+    }
+
+    // Returns mutable access to the contiguous storage.
+    T* data() noexcept
+    {
+        return reinterpret_cast<T*>(buf);
+    }
+
+    // Returns read-only access to the contiguous storage.
+    const T* data() const noexcept
+    {
+        return reinterpret_cast<const T*>(buf);
+    }
+
+    // Returns an iterator to the first element.
+    iterator begin() noexcept
+    {
+        return data();
+    }
+
+    // Returns a const iterator to the first element.
+    const_iterator begin() const noexcept
+    {
+        return data();
+    }
+
+    // Returns a const iterator to the first element.
+    const_iterator cbegin() const noexcept
+    {
+        return data();
+    }
+
+    // Returns an iterator one past the last element.
+    iterator end() noexcept
+    {
+        return data() + len;
+    }
+
+    // Returns a const iterator one past the last element.
+    const_iterator end() const noexcept
+    {
+        return data() + len;
+    }
+
+    // Returns a const iterator one past the last element.
+    const_iterator cend() const noexcept
+    {
+        return data() + len;
+    }
+
+    // Returns a reference to the element at the requested index.
+    [[nodiscard]] T& operator[](size_t idx) noexcept
+    {
+        assert(idx < len);
+        return data()[idx]; // WARNING: no bounds check
+    }
+
+    // Returns a read-only reference to the element at the requested index.
+    [[nodiscard]] const T& operator[](size_t idx) const noexcept
+    {
+        assert(idx < len);
+        return data()[idx];
+    }
+
+    // Returns a reference to the first element.
+    [[nodiscard]] T& front() noexcept
+    {
+        assert(len > 0);
+        return data()[0];
+    }
+
+    // Returns a read-only reference to the first element.
+    [[nodiscard]] const T& front() const noexcept
+    {
+        assert(len > 0);
+        return data()[0];
+    }
+
+    // Returns a reference to the last element.
+    [[nodiscard]] T& back() noexcept
+    {
+        assert(len > 0);
+        return data()[len - 1];
+    }
+
+    // Returns a read-only reference to the last element.
+    [[nodiscard]] const T& back() const noexcept
+    {
+        assert(len > 0);
+        return data()[len - 1];
+    }
+
+    // Destroys all elements.
+    void clear() noexcept
+    {
+        destroy_range(0, len);
+        len = 0;
+    }
+
+    // Removes the last element.
+    void pop_back() noexcept
+    {
+        assert(len > 0);
+        len--;
+        destroy_range(len, len + 1);
+    }
+
+    // Reports whether the fixed capacity can hold the requested number of elements.
+    [[nodiscard]] bool reserve(size_t newCapacity) const noexcept
+    {
+        return newCapacity <= N;
+    }
+
+    // No-op kept for API compatibility with lightstd::vector.
+    [[nodiscard]] bool shrink_to_fit() const noexcept
+    {
+        return true;
+    }
+
+    // Resizes the vector using default construction for new elements.
+    [[nodiscard]] bool resize(size_t newLen) noexcept
+    {
+        static_assert(std::is_nothrow_default_constructible_v<T>,
+                    "resize(grow) requires T to be nothrow default constructible.");
+
+        if (newLen > N) {
+            return false;
+        }
+        if (newLen < len) {
+            resize_down(newLen);
+            return true;
+        }
+
+        for (size_t i = len; i < newLen; ++i) {
+            ::new (static_cast<void*>(data() + i)) T();
+        }
+
+        len = newLen;
+        return true;
+    }
+
+    // Resizes the vector using copies of the provided fill value.
+    [[nodiscard]] bool resize(size_t newLen, const T& fillValue) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "resize(n, value) requires T to be nothrow copy constructible.");
+
+        if (newLen > N) {
+            return false;
+        }
+        if (newLen < len) {
+            resize_down(newLen);
+            return true;
+        }
+
+        // The storage never moves, so a fill value aliasing an element stays valid.
+        for (size_t i = len; i < newLen; ++i) {
+            ::new (static_cast<void*>(data() + i)) T(fillValue);
+        }
+
+        len = newLen;
+        return true;
+    }
+
+    // Resizes the vector leaving new elements uninitialized, for buffers that are about to be overwritten.
+    [[nodiscard]] bool resize_uninitialized(size_t newLen) noexcept
+    {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "resize_uninitialized requires T to be a trivial type.");
+
+        if (newLen > N) {
+            return false;
+        }
+
+        len = newLen;
+        return true;
+    }
+
+    // Appends a copy of the provided element.
+    [[nodiscard]] bool push_back(const T& v) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "push_back(const T&) requires T to be nothrow copy constructible.");
+
+        if (len == N) {
+            return false;
+        }
+
+        ::new (static_cast<void*>(data() + len)) T(v);
+
+        len++;
+        return true;
+    }
+
+    // Appends the provided element by move.
+    [[nodiscard]] bool push_back(T&& v) noexcept
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "push_back(T&&) requires T to be nothrow move constructible.");
+
+        if (len == N) {
+            return false;
+        }
+
+        ::new (static_cast<void*>(data() + len)) T(std::move(v));
+
+        len++;
+        return true;
+    }
+
+    // Constructs a new element in place at the end of the vector.
+    template <class... Args>
+    [[nodiscard]] bool emplace_back(Args&&... args) noexcept
+    {
+        static_assert(std::is_nothrow_constructible_v<T, Args...>, "emplace_back requires T(args...) to be nothrow constructible.");
+
+        if (len == N) {
+            return false;
+        }
+
+        ::new (static_cast<void*>(data() + len)) T(std::forward<Args>(args)...);
+
+        len++;
+        return true;
+    }
+
+    // Shrinks the logical size.
+    void resize_down(size_t newLen) noexcept
+    {
+        assert(newLen <= len);
+        destroy_range(newLen, len);
+        len = newLen;
+    }
+
+    // Appends a copy of count elements taken from a contiguous source range.
+    [[nodiscard]] bool append(const T* src, size_t count) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "append requires T to be nothrow copy constructible.");
+
+        if (count > N - len) {
+            return false;
+        }
+        assert(src || count == 0);
+
+        detail::vector_copy_construct(data() + len, src, count);
+
+        len += count;
+        return true;
+    }
+
+    // Inserts a copy of the range [first, last) before pos.
+    [[nodiscard]] bool insert(const_iterator pos, const T* first, const T* last) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "insert requires T to be nothrow copy constructible.");
+
+        assert(pos >= cbegin() && pos <= cend());
+        assert(first <= last);
+
+        T* ptr = data();
+        const size_t idx = static_cast<size_t>(pos - cbegin());
+        const size_t count = static_cast<size_t>(last - first);
+
+        if (count > N - len) {
+            return false;
+        }
+        if (count == 0) {
+            return true;
+        }
+        if (idx == len) {
+            return append(first, count);
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            const bool aliases = (first >= ptr && first < ptr + len);
+
+            memmove(ptr + idx + count, ptr + idx, (len - idx) * sizeof(T));
+            if (!aliases) {
+                memcpy(ptr + idx, first, count * sizeof(T));
+            }
+            else {
+                // Source elements located before the gap did not move while
+                // the ones at or after it were shifted by count positions.
+                const size_t aliasIdx = static_cast<size_t>(first - ptr);
+                size_t before = (aliasIdx < idx) ? idx - aliasIdx : 0;
+
+                if (before > count) {
+                    before = count;
+                }
+                if (before > 0) {
+                    memcpy(ptr + idx, first, before * sizeof(T));
+                }
+                if (before < count) {
+                    memcpy(ptr + idx + before, first + before + count, (count - before) * sizeof(T));
+                }
+            }
+        }
+        else {
+            // Construct the new elements at the end, then rotate them into place.
+            detail::vector_copy_construct(ptr + len, first, count);
+            detail::vector_rotate(ptr, idx, len, len + count);
+        }
+
+        len += count;
+        return true;
+    }
+
+    // Removes the elements in [first, last) and returns an iterator to the element that followed them.
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        assert(first >= cbegin() && first <= last && last <= cend());
+
+        T* ptr = data();
+        const size_t from = static_cast<size_t>(first - cbegin());
+        const size_t to = static_cast<size_t>(last - cbegin());
+
+        if (from == to) {
+            return ptr + from;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            memmove(ptr + from, ptr + to, (len - to) * sizeof(T));
+        }
+        else {
+            for (size_t i = to; i < len; ++i) {
+                ptr[from + (i - to)] = std::move(ptr[i]);
+            }
+            destroy_range(len - (to - from), len);
+        }
+
+        len -= to - from;
+        return ptr + from;
+    }
+
+    // Replaces the contents with count copies of the provided value.
+    [[nodiscard]] bool assign(size_t count, const T& value) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "assign requires T to be nothrow copy constructible.");
+
+        if (count > N) {
+            return false;
+        }
+
+        // Keep a private copy if the value lives inside the buffer being replaced.
+        if (&value >= data() && &value < data() + len) {
+            T valueCopy(value);
+
+            return assign(count, valueCopy);
+        }
+
+        clear();
+        for (size_t i = 0; i < count; ++i) {
+            ::new (static_cast<void*>(data() + i)) T(value);
+        }
+
+        len = count;
+        return true;
+    }
+
+private:
+    void take_from(static_vector& other) noexcept
+    {
+        detail::vector_move_construct(data(), other.data(), other.len);
+        other.destroy_range(0, other.len);
+        len = other.len;
+        other.len = 0;
+    }
+
+    void destroy_range(size_t from, size_t to) noexcept
+    {
+        // Trivially destructible types (int, float, pointers, etc.) need no destructor call.
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            // Destroy in reverse order [to-1 .. from] to mirror construction order.
+            for (size_t i = to; i > from; --i) {
+                data()[i - 1].~T();
+            }
+        }
+    }
+
+private:
+    // Constant initialization needs every member initialized. Initializing the one-byte member of the
+    // union satisfies it without zero-filling the element storage on every construction.
+    union {
+        char unused;
+        alignas(T) unsigned char buf[N * sizeof(T)];
+    };
+    size_t len;
+};
+
+} // namespace lightstd
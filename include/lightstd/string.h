@@ -5,7 +5,11 @@
 #endif // !__cplusplus
 
 #include "allocator.h"
+#include "string_view.h"
 #include <assert.h>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
 #include <cstring>
 
 // -----------------------------------------------------------------------------
@@ -13,32 +17,52 @@
 namespace lightstd {
 
 // NOTE: lightstd::string does NOT throw exceptions on purpose.
+// Short strings (up to SSO_CAPACITY characters) are stored inline and never touch the allocator.
 class string
 {
 public:
     using iterator        = char*;
     using const_iterator  = const char*;
 
+private:
+    typedef struct HeapData_s {
+        char* ptr;
+        size_t len;
+        size_t cap;
+    } HeapData_t;
+
+    static constexpr size_t SSO_BUFFER_SIZE = (sizeof(HeapData_t) < 16) ? 16 : (sizeof(HeapData_t) + sizeof(size_t));
+    // The last byte of the inline buffer stores the remaining inline room, so it becomes the
+    // trailing nul when the inline buffer is full. Heap-allocated strings mark it with HEAP_TAG.
+    static constexpr unsigned char HEAP_TAG = 0xFF;
+
+    static_assert(sizeof(HeapData_t) < SSO_BUFFER_SIZE, "string: the heap fields must not overlap the tag byte.");
+    static_assert(SSO_BUFFER_SIZE - 1 < HEAP_TAG, "string: inline capacity must not collide with the heap tag.");
+
+public:
+    // Maximum number of characters stored without allocating.
+    static constexpr size_t SSO_CAPACITY = SSO_BUFFER_SIZE - 1;
+
     // Creates an empty string using the provided allocator or the default one.
     string(IAllocator *_alloc = nullptr) noexcept
     {
         alloc = _alloc ? _alloc : IAllocator::getDefault();
+        set_inline_length(0);
     }
 
     string(const string&) = delete;
     // Transfers ownership of the string buffer.
-    string(string&& other) noexcept : ptr(other.ptr), len(other.len), cap(other.cap), alloc(other.alloc)
+    string(string&& other) noexcept : alloc(other.alloc)
     {
-        other.ptr = nullptr;
-        other.len = 0;
-        other.cap = 0;
+        memcpy(&storage, &other.storage, sizeof(storage));
+        other.set_inline_length(0);
     }
 
     // Releases the owned character buffer.
     ~string()
     {
-        if (ptr) {
-            alloc->deallocate(ptr);
+        if (is_heap()) {
+            alloc->deallocate(storage.heap.ptr);
         }
     }
 
@@ -46,18 +70,14 @@ public:
     string& operator=(string&& other) noexcept
     {
         if (this != &other) {
-            if (ptr) {
-                alloc->deallocate(ptr);
+            if (is_heap()) {
+                alloc->deallocate(storage.heap.ptr);
             }
 
-            ptr = other.ptr;
-            len = other.len;
-            cap = other.cap;
+            memcpy(&storage, &other.storage, sizeof(storage));
             alloc = other.alloc;
 
-            other.ptr = nullptr;
-            other.len = 0;
-            other.cap = 0;
+            other.set_inline_length(0);
         }
         return *this;
     }
@@ -65,26 +85,25 @@ public:
     // Returns the number of characters excluding the trailing nul.
     [[nodiscard]] size_t length() const noexcept
     {
-        return len;
+        return is_heap() ? storage.heap.len : SSO_CAPACITY - tag();
     }
 
     // Returns the allocated character capacity excluding the trailing nul.
     [[nodiscard]] size_t capacity() const noexcept
     {
-        return cap;
+        return is_heap() ? storage.heap.cap : SSO_CAPACITY;
     }
 
     // Reports whether the string contains no characters.
     [[nodiscard]] bool empty() const noexcept
     {
-        return len == 0;
+        return length() == 0;
     }
 
     // Returns mutable access to the contiguous character buffer.
     char* data() noexcept
     {
-        assert(ptr);
-        return ptr;
+        return is_heap() ? storage.heap.ptr : storage.sso;
     }
 
     // Returns read-only access to the contiguous character buffer.
@@ -96,8 +115,7 @@ public:
     // Returns a nul-terminated view of the string contents.
     const char* c_str() const noexcept
     {
-        static const char empty[1] = "";
-        return ptr ? ptr : empty;
+        return is_heap() ? storage.heap.ptr : storage.sso;
     }
 
     // Implicitly exposes the string as a nul-terminated C string.
@@ -109,74 +127,105 @@ public:
     // Returns an iterator to the first character.
     iterator begin() noexcept
     {
-        return ptr;
+        return data();
     }
 
     // Returns a const iterator to the first character.
     const_iterator begin() const noexcept
     {
-        return ptr;
+        return c_str();
     }
 
     // Returns a const iterator to the first character.
     const_iterator cbegin() const noexcept
     {
-        return ptr;
+        return c_str();
     }
 
     // Returns an iterator one past the last character.
     iterator end() noexcept
     {
-        return ptr + len;
+        return data() + length();
     }
 
     // Returns a const iterator one past the last character.
     const_iterator end() const noexcept
     {
-        return ptr + len;
+        return c_str() + length();
     }
 
     // Returns a const iterator one past the last character.
     const_iterator cend() const noexcept
     {
-        return ptr + len;
+        return c_str() + length();
     }
 
     // Returns a reference to the character at the requested index.
     [[nodiscard]] char& operator[](size_t idx) noexcept
     {
-        assert(ptr);
-        assert(idx < len);
-        return ptr[idx]; // WARNING: no bounds check
+        assert(idx < length());
+        return data()[idx]; // WARNING: no bounds check
     }
 
     // Returns a read-only reference to the character at the requested index.
     [[nodiscard]] const char& operator[](size_t idx) const noexcept
     {
-        assert(ptr);
-        assert(idx < len);
-        return ptr[idx];
+        assert(idx < length());
+        return c_str()[idx];
     }
 
     // Reports whether the string contains at least one character.
     explicit operator bool() const noexcept
     {
-        return len != 0;
+        return length() != 0;
     }
 
     // Reports whether the string is empty.
     bool operator!() const noexcept
     {
-        return len == 0;
+        return length() == 0;
+    }
+
+    // Returns a view of the string contents.
+    [[nodiscard]] string_view view() const noexcept
+    {
+        return string_view(c_str(), length());
+    }
+
+    // Compares lexicographically and returns a negative, zero or positive value.
+    [[nodiscard]] int compare(string_view other) const noexcept
+    {
+        return view().compare(other);
+    }
+
+    // Reports whether the string begins with prefix.
+    [[nodiscard]] bool starts_with(string_view prefix) const noexcept
+    {
+        return view().starts_with(prefix);
+    }
+
+    // Reports whether the string ends with suffix.
+    [[nodiscard]] bool ends_with(string_view suffix) const noexcept
+    {
+        return view().ends_with(suffix);
+    }
+
+    // Returns the index of the first c at or after pos, or string_view::npos.
+    [[nodiscard]] size_t find(char c, size_t pos = 0) const noexcept
+    {
+        return view().find(c, pos);
+    }
+
+    // Returns the index of the first occurrence of needle at or after pos, or string_view::npos.
+    [[nodiscard]] size_t find(string_view needle, size_t pos = 0) const noexcept
+    {
+        return view().find(needle, pos);
     }
 
     // Removes all characters while keeping the current allocation.
     void clear() noexcept
     {
-        len = 0;
-        if (ptr) {
-            ptr[0] = '\0';
-        }
+        set_length(0);
     }
 
     // Appends a nul-terminated string.
@@ -194,32 +243,209 @@ public:
     // Appends a byte range without requiring a trailing nul.
     bool append(const char* src, size_t srcLen) noexcept
     {
+        size_t len;
+
         if ((!src) || srcLen == 0) {
             return true;
         }
 
-        if (!reserve(len + srcLen)) {
-            return false;
+        len = length();
+        if (srcLen > capacity() - len) {
+            // The source may be part of this string, so locate it again after growing.
+            const char *cur = c_str();
+            const bool aliases = (src >= cur && src < cur + len);
+            const size_t aliasIdx = aliases ? static_cast<size_t>(src - cur) : 0;
+
+            if (srcLen > max_length() - len) {
+                return false;
+            }
+            if (!reserve(growth_capacity(len + srcLen))) {
+                return false;
+            }
+            if (aliases) {
+                src = c_str() + aliasIdx;
+            }
         }
 
-        memcpy(ptr + len, src, srcLen);
-        len += srcLen;
-        ptr[len] = '\0';
+        memmove(data() + len, src, srcLen);
+        set_length(len + srcLen);
         return true;
     }
 
     // Appends a single character.
     bool push_back(char c) noexcept
     {
-        return append(&c, 1);
+        size_t len = length();
+
+        if (len == capacity()) {
+            if (len == max_length()) {
+                return false;
+            }
+            if (!reserve(growth_capacity(len + 1))) {
+                return false;
+            }
+        }
+        data()[len] = c;
+        set_length(len + 1);
+        return true;
+    }
+
+    // Appends printf-style formatted text, writing directly into the spare capacity.
+    // The string grows at most once if the output does not fit.
+    // NOTE: Neither fmt nor any argument may point into this string. Use snprintf and append() for that.
+    bool appendf(const char* fmt, ...) noexcept __attribute__((format(printf, 2, 3)))
+    {
+        va_list args;
+        bool ok;
+
+        va_start(args, fmt);
+        ok = appendvf(fmt, args);
+        va_end(args);
+        return ok;
+    }
+
+    // va_list variant of appendf. Same aliasing restriction.
+    bool appendvf(const char* fmt, va_list args) noexcept
+    {
+        va_list argsCopy;
+        size_t len = length();
+        size_t room = capacity() - len;
+        int written;
+
+        assert(fmt < c_str() || fmt > c_str() + capacity());
+
+        va_copy(argsCopy, args);
+        written = vsnprintf(data() + len, room + 1, fmt, argsCopy);
+        va_end(argsCopy);
+
+        if (written < 0 || (size_t)written > room) {
+            // vsnprintf may have clobbered the inline length tag, so restore the length before anything else.
+            set_length(len);
+        }
+        if (written < 0) {
+            return false;
+        }
+        if ((size_t)written > room) {
+            if ((size_t)written > max_length() - len) {
+                return false;
+            }
+            if (!reserve(growth_capacity(len + (size_t)written))) {
+                return false;
+            }
+            vsnprintf(data() + len, (size_t)written + 1, fmt, args);
+        }
+        set_length(len + (size_t)written);
+        return true;
+    }
+
+    // Appends a signed integer in decimal notation.
+    bool appendInt(int64_t value) noexcept
+    {
+        char buf[24];
+        size_t pos;
+
+        if (value >= 0) {
+            pos = format_uint((uint64_t)value, buf, sizeof(buf));
+        }
+        else {
+            // Negate in unsigned arithmetic so INT64_MIN does not overflow.
+            pos = format_uint(0 - (uint64_t)value, buf, sizeof(buf));
+            buf[--pos] = '-';
+        }
+        return append(buf + pos, sizeof(buf) - pos);
+    }
+
+    // Appends an unsigned integer in decimal notation.
+    bool appendUInt(uint64_t value) noexcept
+    {
+        char buf[24];
+        size_t pos = format_uint(value, buf, sizeof(buf));
+
+        return append(buf + pos, sizeof(buf) - pos);
+    }
+
+    // Appends an unsigned integer in hexadecimal notation, left-padded with zeroes up to minDigits.
+    bool appendHex(uint64_t value, size_t minDigits = 0, bool upperCase = false) noexcept
+    {
+        const char *digits = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+        char buf[16];
+        size_t pos = sizeof(buf);
+
+        if (minDigits > sizeof(buf)) {
+            minDigits = sizeof(buf);
+        }
+        do {
+            buf[--pos] = digits[value & 0x0F];
+            value >>= 4;
+        }
+        while (value != 0);
+        while (sizeof(buf) - pos < minDigits) {
+            buf[--pos] = '0';
+        }
+        return append(buf + pos, sizeof(buf) - pos);
     }
 
-    // Ensures capacity for at least the requested character count.
+    // Appends a floating-point value with a fixed number of decimals (up to 9), rounding half away from zero.
+    bool appendFixed(double value, unsigned int decimals) noexcept
+    {
+        char buf[40];
+        uint64_t intPart, fracPart, scale;
+        size_t pos;
+        bool negative;
+
+        if (value != value) {
+            return append("nan", 3);
+        }
+        if (decimals > 9) {
+            decimals = 9;
+        }
+        negative = (value < 0);
+        if (negative) {
+            value = -value;
+        }
+        if (value >= 18446744073709551615.0) {
+            // Out of integer range (including infinity), let the C library deal with it.
+            return appendf("%.*f", (int)decimals, negative ? -value : value);
+        }
+
+        scale = 1;
+        for (unsigned int i = 0; i < decimals; i++) {
+            scale *= 10;
+        }
+        intPart = (uint64_t)value;
+        fracPart = (uint64_t)((value - (double)intPart) * (double)scale + 0.5);
+        if (fracPart >= scale) {
+            intPart += 1;
+            fracPart -= scale;
+        }
+        // Values rounding to zero are printed without sign.
+        if (intPart == 0 && fracPart == 0) {
+            negative = false;
+        }
+
+        // Build the text right to left: decimals, point, integer part, sign.
+        pos = sizeof(buf);
+        for (unsigned int i = 0; i < decimals; i++) {
+            buf[--pos] = (char)('0' + (fracPart % 10));
+            fracPart /= 10;
+        }
+        if (decimals > 0) {
+            buf[--pos] = '.';
+        }
+        pos = format_uint(intPart, buf, pos);
+        if (negative) {
+            buf[--pos] = '-';
+        }
+        return append(buf + pos, sizeof(buf) - pos);
+    }
+
+    // Ensures capacity for at least the requested character count. Unlike append, it allocates exactly.
     [[nodiscard]] bool reserve(size_t newCapacity) noexcept
     {
         char* newPtr;
+        size_t len;
 
-        if (newCapacity <= cap) {
+        if (newCapacity <= capacity()) {
             return true;
         }
 
@@ -228,45 +454,135 @@ public:
         if (!newPtr) {
             return false;
         }
-        if (ptr) {
-            memcpy(newPtr, ptr, len);
-            alloc->deallocate(ptr);
+        len = length();
+        memcpy(newPtr, c_str(), len + 1);
+        if (is_heap()) {
+            alloc->deallocate(storage.heap.ptr);
+        }
+        storage.heap.ptr = newPtr;
+        storage.heap.len = len;
+        storage.heap.cap = newCapacity;
+        set_tag(HEAP_TAG);
+        return true;
+    }
+
+    // Releases unused capacity, moving the contents back inline when they fit.
+    [[nodiscard]] bool shrink_to_fit() noexcept
+    {
+        char* heapPtr;
+        size_t len;
+
+        if (!is_heap()) {
+            return true;
+        }
+        len = storage.heap.len;
+        if (len == storage.heap.cap) {
+            return true;
+        }
+
+        heapPtr = storage.heap.ptr;
+        if (len <= SSO_CAPACITY) {
+            memcpy(storage.sso, heapPtr, len);
+            set_inline_length(len);
         }
         else {
-            len = 0;
+            char* newPtr = (char *)alloc->allocate(len + 1);
+            if (!newPtr) {
+                return false;
+            }
+            memcpy(newPtr, heapPtr, len + 1);
+            storage.heap.ptr = newPtr;
+            storage.heap.cap = len;
         }
-        ptr = newPtr;
-        cap = newCapacity;
-        ptr[len] = '\0';
+        alloc->deallocate(heapPtr);
         return true;
     }
 
     // Resizes the string and preserves nul termination.
     [[nodiscard]] bool resize(size_t newLen) noexcept
     {
-        if (newLen > cap) {
+        if (newLen > capacity()) {
             if (!reserve(newLen)) {
                 return false;
             }
         }
-        else if (cap == 0) {
-            // Try to allocate some room if the string is empty
-            // regardless we are not adding anything to the string
-            if (!reserve(16)) {
-                return false;
-            }
+        set_length(newLen);
+        return true;
+    }
+
+private:
+    static constexpr size_t max_length() noexcept
+    {
+        return ((size_t)-1) / 2;
+    }
+
+    // Writes the decimal digits of value right-aligned before buf[end] and returns the index of the first one.
+    static size_t format_uint(uint64_t value, char* buf, size_t end) noexcept
+    {
+        uint32_t value32;
+
+        // 64-bit division is a library call on 32-bit cores, so only use it while the value needs it.
+        while (value > 0xFFFFFFFFu) {
+            buf[--end] = (char)('0' + (value % 10));
+            value /= 10;
         }
-        len = newLen;
-        if (ptr) {
-            ptr[len] = '\0';
+        value32 = (uint32_t)value;
+        do {
+            buf[--end] = (char)('0' + (value32 % 10));
+            value32 /= 10;
+        }
+        while (value32 != 0);
+        return end;
+    }
+
+    // Doubles the capacity on append so building a string character by character is amortized linear.
+    size_t growth_capacity(size_t minNeeded) const noexcept
+    {
+        size_t c = capacity();
+
+        c = (c > max_length() / 2) ? max_length() : c * 2;
+        return (c < minNeeded) ? minNeeded : c;
+    }
+
+    unsigned char tag() const noexcept
+    {
+        return static_cast<unsigned char>(storage.sso[SSO_BUFFER_SIZE - 1]);
+    }
+
+    void set_tag(unsigned char value) noexcept
+    {
+        storage.sso[SSO_BUFFER_SIZE - 1] = static_cast<char>(value);
+    }
+
+    bool is_heap() const noexcept
+    {
+        return tag() == HEAP_TAG;
+    }
+
+    void set_inline_length(size_t newLen) noexcept
+    {
+        assert(newLen <= SSO_CAPACITY);
+        storage.sso[newLen] = '\0';
+        set_tag(static_cast<unsigned char>(SSO_CAPACITY - newLen));
+    }
+
+    void set_length(size_t newLen) noexcept
+    {
+        if (is_heap()) {
+            assert(newLen <= storage.heap.cap);
+            storage.heap.len = newLen;
+            storage.heap.ptr[newLen] = '\0';
+        }
+        else {
+            set_inline_length(newLen);
         }
-        return true;
     }
 
 private:
-    char* ptr{nullptr};
-    size_t len{0};
-    size_t cap{0};
+    union {
+        HeapData_t heap;
+        char sso[SSO_BUFFER_SIZE];
+    } storage;
     IAllocator *alloc{nullptr};
 };
 
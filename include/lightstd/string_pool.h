@@ -0,0 +1,270 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include "allocator.h"
+#include "fnv.h"
+#include "string_view.h"
+#include "vector.h"
+#include <assert.h>
+#include <cstdint>
+#include <cstring>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+// Interns strings: each distinct value is stored once, in an arena of fixed-size chunks, and is
+// identified by a compact 32-bit handle. Two handles from the same pool are equal if and only if
+// the strings are equal, so comparisons become a single integer compare.
+// Interned strings are never moved, their c_str() pointers remain valid until clear() or destruction.
+// NOTE: string_pool is not thread-safe; guard shared pools with a Mutex.
+// NOTE: lightstd::string_pool does NOT throw exceptions on purpose.
+class string_pool
+{
+public:
+    typedef uint32_t handle_t;
+
+    // Handle value never returned for a valid string.
+    static constexpr handle_t INVALID_HANDLE = 0;
+
+    // Creates an empty pool. Strings longer than chunkSize get a dedicated arena chunk.
+    string_pool(IAllocator *_alloc = nullptr, size_t _chunkSize = 256) noexcept : entries(_alloc), buckets(_alloc),
+                                                                               chunkSize(_chunkSize)
+    {
+        alloc = _alloc ? _alloc : IAllocator::getDefault();
+    }
+
+    string_pool(const string_pool&) = delete;
+    // Transfers ownership of the interned strings.
+    string_pool(string_pool&& other) noexcept : entries(std::move(other.entries)), buckets(std::move(other.buckets)),
+                                                chunks(other.chunks), chunkSize(other.chunkSize), alloc(other.alloc)
+    {
+        other.chunks = nullptr;
+    }
+
+    // Releases all interned strings.
+    ~string_pool() noexcept
+    {
+        release_chunks();
+    }
+
+    string_pool& operator=(const string_pool&) = delete;
+    string_pool& operator=(string_pool&& other) noexcept
+    {
+        if (this != &other) {
+            release_chunks();
+
+            entries = std::move(other.entries);
+            buckets = std::move(other.buckets);
+            chunks = other.chunks;
+            chunkSize = other.chunkSize;
+            alloc = other.alloc;
+
+            other.chunks = nullptr;
+        }
+        return *this;
+    }
+
+    // Returns the handle of the string, storing it first if it is not in the pool yet.
+    // Returns INVALID_HANDLE if memory is exhausted.
+    [[nodiscard]] handle_t intern(string_view str) noexcept
+    {
+        uint32_t hash = fnv1a32(str.data(), str.length());
+        size_t slot = find_slot(str, hash);
+        Entry_t entry;
+
+        if (slot != NOT_FOUND && buckets[slot] != INVALID_HANDLE) {
+            return buckets[slot];
+        }
+
+        // Make room in the index first so a failure does not leave an orphan entry behind.
+        if (entries.size() >= UINT32_MAX - 1) {
+            return INVALID_HANDLE;
+        }
+        if ((entries.size() + 1) * 4 > buckets.size() * 3) {
+            if (!grow_buckets()) {
+                return INVALID_HANDLE;
+            }
+            slot = find_slot(str, hash);
+        }
+        if (!entries.reserve(entries.size() + 1)) {
+            return INVALID_HANDLE;
+        }
+
+        entry.str = store(str);
+        if (!entry.str) {
+            return INVALID_HANDLE;
+        }
+        entry.len = (uint32_t)str.length();
+        entry.hash = hash;
+        if (!entries.push_back(entry)) {
+            return INVALID_HANDLE; // Unreachable, capacity was reserved above.
+        }
+
+        buckets[slot] = (handle_t)entries.size();
+        return buckets[slot];
+    }
+
+    // Returns the handle of the string or INVALID_HANDLE if it was never interned.
+    [[nodiscard]] handle_t find(string_view str) const noexcept
+    {
+        size_t slot = find_slot(str, fnv1a32(str.data(), str.length()));
+
+        return (slot != NOT_FOUND) ? buckets[slot] : INVALID_HANDLE;
+    }
+
+    // Returns the nul-terminated text of an interned string.
+    [[nodiscard]] const char* c_str(handle_t handle) const noexcept
+    {
+        assert(handle != INVALID_HANDLE && handle <= entries.size());
+        return entries[handle - 1].str;
+    }
+
+    // Returns the length of an interned string.
+    [[nodiscard]] size_t length(handle_t handle) const noexcept
+    {
+        assert(handle != INVALID_HANDLE && handle <= entries.size());
+        return entries[handle - 1].len;
+    }
+
+    // Returns a view of an interned string.
+    [[nodiscard]] string_view view(handle_t handle) const noexcept
+    {
+        assert(handle != INVALID_HANDLE && handle <= entries.size());
+        return string_view(entries[handle - 1].str, entries[handle - 1].len);
+    }
+
+    // Returns the number of distinct strings in the pool.
+    [[nodiscard]] size_t size() const noexcept
+    {
+        return entries.size();
+    }
+
+    // Removes every string. Previously returned handles and pointers become invalid.
+    void clear() noexcept
+    {
+        release_chunks();
+        entries.clear();
+        buckets.clear();
+    }
+
+private:
+    typedef struct Entry_s {
+        const char *str;
+        uint32_t len;
+        uint32_t hash;
+    } Entry_t;
+
+    typedef struct Chunk_s {
+        struct Chunk_s *next;
+        size_t used;
+        size_t size;
+    } Chunk_t;
+
+    static constexpr size_t NOT_FOUND = (size_t)-1;
+
+    // Returns the bucket holding str, or the empty bucket where it would go. NOT_FOUND if there is no index yet.
+    size_t find_slot(string_view str, uint32_t hash) const noexcept
+    {
+        size_t mask, idx;
+
+        if (buckets.empty()) {
+            return NOT_FOUND;
+        }
+
+        mask = buckets.size() - 1;
+        idx = hash & mask;
+        while (buckets[idx] != INVALID_HANDLE) {
+            const Entry_t &e = entries[buckets[idx] - 1];
+
+            if (e.hash == hash && e.len == str.length() && memcmp(e.str, str.data(), str.length()) == 0) {
+                break;
+            }
+            idx = (idx + 1) & mask;
+        }
+        return idx;
+    }
+
+    bool grow_buckets() noexcept
+    {
+        vector<handle_t> newBuckets(alloc);
+        size_t newSize = buckets.empty() ? 16 : buckets.size() * 2;
+        size_t mask = newSize - 1;
+
+        if (!newBuckets.assign(newSize, INVALID_HANDLE)) {
+            return false;
+        }
+        for (size_t i = 0; i < entries.size(); i++) {
+            size_t idx = entries[i].hash & mask;
+
+            while (newBuckets[idx] != INVALID_HANDLE) {
+                idx = (idx + 1) & mask;
+            }
+            newBuckets[idx] = (handle_t)(i + 1);
+        }
+
+        buckets = std::move(newBuckets);
+        return true;
+    }
+
+    // Copies the string, plus a trailing nul, into the arena.
+    const char* store(string_view str) noexcept
+    {
+        size_t needed = str.length() + 1;
+        char *dest;
+
+        if ((!chunks) || chunks->size - chunks->used < needed) {
+            size_t size = (needed > chunkSize) ? needed : chunkSize;
+            Chunk_t *chunk = (Chunk_t *)alloc->allocate(sizeof(Chunk_t) + size);
+
+            if (!chunk) {
+                return nullptr;
+            }
+            chunk->used = 0;
+            chunk->size = size;
+            if (chunks && needed > chunkSize) {
+                // Keep filling the current chunk, the dedicated one is full already.
+                chunk->next = chunks->next;
+                chunks->next = chunk;
+            }
+            else {
+                chunk->next = chunks;
+                chunks = chunk;
+            }
+            dest = reinterpret_cast<char*>(chunk + 1);
+            chunk->used = needed;
+        }
+        else {
+            dest = reinterpret_cast<char*>(chunks + 1) + chunks->used;
+            chunks->used += needed;
+        }
+
+        if (str.length() > 0) {
+            memcpy(dest, str.data(), str.length());
+        }
+        dest[str.length()] = '\0';
+        return dest;
+    }
+
+    void release_chunks() noexcept
+    {
+        while (chunks) {
+            Chunk_t *next = chunks->next;
+
+            alloc->deallocate(chunks);
+            chunks = next;
+        }
+    }
+
+private:
+    vector<Entry_t> entries;
+    vector<handle_t> buckets;
+    Chunk_t *chunks{nullptr};
+    size_t chunkSize;
+    IAllocator *alloc{nullptr};
+};
+
+} // namespace lightstd
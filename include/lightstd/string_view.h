@@ -0,0 +1,308 @@
+#pragma once
+
+#ifndef __cplusplus
+    #error C++ compiler required.
+#endif // !__cplusplus
+
+#include <assert.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// -----------------------------------------------------------------------------
+
+namespace lightstd {
+
+class string;
+
+// Non-owning view over a character range. It is NOT necessarily nul-terminated.
+class string_view
+{
+public:
+    using iterator        = const char*;
+    using const_iterator  = const char*;
+
+    static constexpr size_t npos = (size_t)-1;
+
+    // Creates an empty view.
+    constexpr string_view() noexcept = default;
+    // Creates a view over a nul-terminated string.
+    string_view(const char *str) noexcept : ptr(str), len(str ? strlen(str) : 0)
+    {
+    }
+    // Creates a view over count characters starting at str.
+    constexpr string_view(const char *str, size_t count) noexcept : ptr(str), len(count)
+    {
+    }
+    // Creates a view over the contents of a lightstd::string.
+    template <class S, std::enable_if_t<std::is_same_v<S, string>, int> = 0>
+    string_view(const S& str) noexcept : ptr(str.c_str()), len(str.length())
+    {
+    }
+
+    constexpr string_view(const string_view&) noexcept = default;
+    constexpr string_view& operator=(const string_view&) noexcept = default;
+
+    // Returns the number of characters in the view.
+    [[nodiscard]] constexpr size_t length() const noexcept
+    {
+        return len;
+    }
+
+    // Returns the number of characters in the view.
+    [[nodiscard]] constexpr size_t size() const noexcept
+    {
+        return len;
+    }
+
+    // Reports whether the view contains no characters.
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return len == 0;
+    }
+
+    // Returns a pointer to the first character.
+    constexpr const char* data() const noexcept
+    {
+        return ptr;
+    }
+
+    // Returns an iterator to the first character.
+    constexpr const_iterator begin() const noexcept
+    {
+        return ptr;
+    }
+
+    // Returns an iterator one past the last character.
+    constexpr const_iterator end() const noexcept
+    {
+        return ptr + len;
+    }
+
+    // Returns the character at the requested index.
+    [[nodiscard]] constexpr char operator[](size_t idx) const noexcept
+    {
+        assert(idx < len);
+        return ptr[idx]; // WARNING: no bounds check
+    }
+
+    // Returns a view of count characters starting at offset, or up to the end if count is npos.
+    // Out of range requests are clamped to the available characters.
+    [[nodiscard]] constexpr string_view substr(size_t offset, size_t count = npos) const noexcept
+    {
+        if (offset > len) {
+            offset = len;
+        }
+        if (count > len - offset) {
+            count = len - offset;
+        }
+        return string_view(ptr + offset, count);
+    }
+
+    // Drops the first count characters from the view.
+    constexpr void remove_prefix(size_t count) noexcept
+    {
+        assert(count <= len);
+        ptr += count;
+        len -= count;
+    }
+
+    // Drops the last count characters from the view.
+    constexpr void remove_suffix(size_t count) noexcept
+    {
+        assert(count <= len);
+        len -= count;
+    }
+
+    // Compares lexicographically and returns a negative, zero or positive value.
+    [[nodiscard]] int compare(string_view other) const noexcept
+    {
+        size_t n = (len < other.len) ? len : other.len;
+        int res = (n > 0) ? memcmp(ptr, other.ptr, n) : 0;
+
+        if (res != 0) {
+            return res;
+        }
+        return (len < other.len) ? -1 : ((len > other.len) ? 1 : 0);
+    }
+
+    // Reports whether the view begins with prefix.
+    [[nodiscard]] bool starts_with(string_view prefix) const noexcept
+    {
+        return prefix.len <= len && (prefix.len == 0 || memcmp(ptr, prefix.ptr, prefix.len) == 0);
+    }
+
+    // Reports whether the view ends with suffix.
+    [[nodiscard]] bool ends_with(string_view suffix) const noexcept
+    {
+        return suffix.len <= len && (suffix.len == 0 || memcmp(ptr + (len - suffix.len), suffix.ptr, suffix.len) == 0);
+    }
+
+    // Returns the index of the first c at or after pos, or npos.
+    [[nodiscard]] size_t find(char c, size_t pos = 0) const noexcept
+    {
+        const void *found;
+
+        if (pos >= len) {
+            return npos;
+        }
+        // memchr scans a word at a time in newlib.
+        found = memchr(ptr + pos, c, len - pos);
+        return found ? static_cast<size_t>(static_cast<const char*>(found) - ptr) : npos;
+    }
+
+    // Returns the index of the first occurrence of needle at or after pos, or npos.
+    [[nodiscard]] size_t find(string_view needle, size_t pos = 0) const noexcept
+    {
+        if (pos > len || needle.len > len - pos) {
+            return npos;
+        }
+        if (needle.len == 0) {
+            return pos;
+        }
+        if (needle.len == 1) {
+            return find(needle.ptr[0], pos);
+        }
+        if (needle.len < 4 || len - pos < 64) {
+            return find_short(needle, pos);
+        }
+        return find_horspool(needle, pos);
+    }
+
+    // Returns the index of the last c, or npos.
+    [[nodiscard]] size_t rfind(char c) const noexcept
+    {
+        for (size_t i = len; i > 0; i--) {
+            if (ptr[i - 1] == c) {
+                return i - 1;
+            }
+        }
+        return npos;
+    }
+
+private:
+    // Anchors on the first needle character with memchr and verifies the rest.
+    size_t find_short(string_view needle, size_t pos) const noexcept
+    {
+        const size_t last = len - needle.len;
+
+        while (pos <= last) {
+            const void *found = memchr(ptr + pos, needle.ptr[0], last - pos + 1);
+
+            if (!found) {
+                break;
+            }
+            pos = static_cast<size_t>(static_cast<const char*>(found) - ptr);
+            if (memcmp(ptr + pos + 1, needle.ptr + 1, needle.len - 1) == 0) {
+                return pos;
+            }
+            pos++;
+        }
+        return npos;
+    }
+
+    // Boyer-Moore-Horspool. Shifts are capped at 255 so the table fits in 256 bytes of stack.
+    size_t find_horspool(string_view needle, size_t pos) const noexcept
+    {
+        uint8_t shift[256];
+        const size_t lastIdx = needle.len - 1;
+        const uint8_t maxShift = (lastIdx < 255) ? (uint8_t)needle.len : 255;
+        const char lastChar = needle.ptr[lastIdx];
+
+        memset(shift, maxShift, sizeof(shift));
+        for (size_t i = (lastIdx > 255) ? lastIdx - 255 : 0; i < lastIdx; i++) {
+            shift[(uint8_t)needle.ptr[i]] = (uint8_t)(lastIdx - i);
+        }
+
+        while (pos <= len - needle.len) {
+            const char c = ptr[pos + lastIdx];
+
+            if (c == lastChar && memcmp(ptr + pos, needle.ptr, lastIdx) == 0) {
+                return pos;
+            }
+            pos += shift[(uint8_t)c];
+        }
+        return npos;
+    }
+
+private:
+    const char *ptr{nullptr};
+    size_t len{0};
+};
+
+// Splits a view into tokens separated by a character or a string delimiter. Tokens are views into the
+// original text: nothing is copied or modified, unlike strtok.
+//
+// Usage:
+//   string_tokenizer tok("home/livingroom/temp", '/');
+//   string_view part;
+//   while (tok.next(part)) { ... }
+class string_tokenizer
+{
+public:
+    // Splits text at every occurrence of delim. Empty tokens are skipped when skipEmpty is set.
+    string_tokenizer(string_view _text, char _delim, bool _skipEmpty = false) noexcept : rest(_text), delimChar(_delim),
+                                                                                         skipEmpty(_skipEmpty)
+    {
+    }
+
+    // Splits text at every occurrence of a multi-character delimiter such as "\r\n".
+    string_tokenizer(string_view _text, string_view _delim, bool _skipEmpty = false) noexcept : rest(_text), delim(_delim),
+                                                                                                skipEmpty(_skipEmpty)
+    {
+        assert(!_delim.empty());
+    }
+
+    // Retrieves the next token. Returns false once the text is exhausted.
+    bool next(string_view& token) noexcept
+    {
+        while (!done) {
+            size_t idx = delim.empty() ? rest.find(delimChar) : rest.find(delim);
+
+            if (idx == string_view::npos) {
+                token = rest;
+                rest = string_view();
+                done = true;
+            }
+            else {
+                token = rest.substr(0, idx);
+                rest.remove_prefix(idx + (delim.empty() ? 1 : delim.length()));
+            }
+            if (!(skipEmpty && token.empty())) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Returns the text that has not been tokenized yet.
+    [[nodiscard]] string_view remaining() const noexcept
+    {
+        return rest;
+    }
+
+private:
+    string_view rest;
+    string_view delim;
+    char delimChar{'\0'};
+    bool skipEmpty{false};
+    bool done{false};
+};
+
+inline bool operator==(string_view a, string_view b) noexcept
+{
+    return a.length() == b.length() && (a.length() == 0 || memcmp(a.data(), b.data(), a.length()) == 0);
+}
+
+inline bool operator!=(string_view a, string_view b) noexcept
+{
+    return !(a == b);
+}
+
+inline bool operator<(string_view a, string_view b) noexcept
+{
+    return a.compare(b) < 0;
+}
+
+} // namespace lightstd
@@ -4,10 +4,22 @@
     #error C++ compiler required.
 #endif // !__cplusplus
 
+#include "allocator.h"
 #include "fnv.h"
+#include "string_view.h"
 #include <esp_err.h>
 #include <cstdint>
 #include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Define LIGHTSTD_HASH_MAP_PROBE_STATS to 1 to count the lookups made by static_hash_map and the slots each
+// one probed. The counters are reported by stats(). They cost two increments per lookup, so they are off
+// by default.
+#ifndef LIGHTSTD_HASH_MAP_PROBE_STATS
+    #define LIGHTSTD_HASH_MAP_PROBE_STATS 0
+#endif // !LIGHTSTD_HASH_MAP_PROBE_STATS
 
 // -----------------------------------------------------------------------------
 
@@ -24,32 +36,299 @@ struct static_hash_map_default_hash
      }
 };
 
+// Default key comparison using operator==.
+template<typename K>
+struct static_hash_map_default_equal
+{
+     // Reports whether both keys are equal.
+     bool operator()(const K& a, const K& b) const
+     {
+         return a == b;
+     }
+};
+
+// Hashes the characters of lightstd::string, string_view and C string keys, so equal text hashes alike
+// wherever it is stored. It is transparent: a string-keyed map can be searched with any of those types.
+struct string_key_hash
+{
+    using is_transparent = void;
+
+    // Hashes the characters of the key.
+    uint32_t operator()(string_view key) const noexcept
+    {
+        return fnv1a32(key.data(), key.length());
+    }
+};
+
+// Compares lightstd::string, string_view and C string keys by content. It is transparent like string_key_hash.
+struct string_key_equal
+{
+    using is_transparent = void;
+
+    // Reports whether both keys hold the same characters.
+    bool operator()(string_view a, string_view b) const noexcept
+    {
+        return a == b;
+    }
+};
+
+template<>
+struct static_hash_map_default_hash<string> : string_key_hash {};
+template<>
+struct static_hash_map_default_hash<string_view> : string_key_hash {};
+template<>
+struct static_hash_map_default_hash<const char*> : string_key_hash {};
+template<>
+struct static_hash_map_default_hash<char*> : string_key_hash {};
+
+template<>
+struct static_hash_map_default_equal<string> : string_key_equal {};
+template<>
+struct static_hash_map_default_equal<string_view> : string_key_equal {};
+template<>
+struct static_hash_map_default_equal<const char*> : string_key_equal {};
+template<>
+struct static_hash_map_default_equal<char*> : string_key_equal {};
+
+namespace detail {
+
+template <class T, class = void>
+struct is_transparent : std::false_type {};
+
+template <class T>
+struct is_transparent<T, std::void_t<typename T::is_transparent>> : std::true_type {};
+
+// Enables lookups by Q in a map keyed by K when both functors accept other key types.
+template <class K, class Q, class HashFn, class KeyEqual>
+using enable_transparent_lookup_t = std::enable_if_t<!std::is_same_v<std::decay_t<Q>, K> && is_transparent<HashFn>::value &&
+                                                     is_transparent<KeyEqual>::value, int>;
+
+} // namespace detail
+
+// Slot layouts for static_hash_map. A layout exposes storage<K, V>, which owns the table memory and gives
+// access to the state, key and value of each slot.
+
+// Keeps the key, value and state of a slot next to each other. Best for small values, a hit touches a single
+// cache line.
+struct hash_map_layout_interleaved
+{
+    template <class K, class V>
+    class storage
+    {
+    private:
+        typedef struct Entry_s {
+            K key;
+            V value;
+            uint8_t state;
+        } Entry_t;
+
+    public:
+        // Bytes taken by each slot, padding included.
+        static constexpr size_t bytes_per_slot = sizeof(Entry_t);
+
+        // Allocates room for count slots. State bytes are left uninitialized.
+        bool allocate(size_t count) noexcept
+        {
+            if (count > SIZE_MAX / sizeof(Entry_t)) {
+                return false;
+            }
+            table = (Entry_t *)malloc(count * sizeof(Entry_t));
+            return table != nullptr;
+        }
+
+        // Wipes and releases the table memory.
+        void release(size_t count) noexcept
+        {
+            if (table) {
+                memset(static_cast<void*>(table), 0, count * sizeof(Entry_t));
+                free(table);
+                table = nullptr;
+            }
+        }
+
+        // Reports whether memory is allocated.
+        bool allocated() const noexcept
+        {
+            return table != nullptr;
+        }
+
+        // Accesses the state byte of a slot.
+        uint8_t& state(size_t idx) noexcept
+        {
+            return table[idx].state;
+        }
+        uint8_t state(size_t idx) const noexcept
+        {
+            return table[idx].state;
+        }
+        // Accesses the key of a slot.
+        K& key(size_t idx) noexcept
+        {
+            return table[idx].key;
+        }
+        const K& key(size_t idx) const noexcept
+        {
+            return table[idx].key;
+        }
+        // Accesses the value of a slot.
+        V& value(size_t idx) noexcept
+        {
+            return table[idx].value;
+        }
+        const V& value(size_t idx) const noexcept
+        {
+            return table[idx].value;
+        }
+
+        // Exchanges the table memory with another storage.
+        void swap(storage& other) noexcept
+        {
+            Entry_t *t = table;
+
+            table = other.table;
+            other.table = t;
+        }
+
+    private:
+        Entry_t *table{nullptr};
+    };
+};
+
+// Stores states, keys and values in three separate arrays within a single allocation. Probing only walks the
+// dense state and key arrays, and no padding is added after each state byte. Best for large values.
+struct hash_map_layout_split
+{
+    template <class K, class V>
+    class storage
+    {
+    public:
+        // Bytes taken by each slot, excluding the constant alignment padding between the arrays.
+        static constexpr size_t bytes_per_slot = 1 + sizeof(K) + sizeof(V);
+
+        // Allocates room for count slots. State bytes are left uninitialized.
+        bool allocate(size_t count) noexcept
+        {
+            size_t keysOffset, valuesOffset;
+
+            if (count > (SIZE_MAX - alignof(K) - alignof(V)) / bytes_per_slot) {
+                return false;
+            }
+            keysOffset = alignUp(count, alignof(K));
+            valuesOffset = alignUp(keysOffset + count * sizeof(K), alignof(V));
+
+            states = (uint8_t *)malloc(valuesOffset + count * sizeof(V));
+            if (!states) {
+                return false;
+            }
+            keys = reinterpret_cast<K*>(states + keysOffset);
+            values = reinterpret_cast<V*>(states + valuesOffset);
+            blockSize = valuesOffset + count * sizeof(V);
+            return true;
+        }
+
+        // Wipes and releases the table memory.
+        void release(size_t) noexcept
+        {
+            if (states) {
+                memset(states, 0, blockSize);
+                free(states);
+                states = nullptr;
+                keys = nullptr;
+                values = nullptr;
+                blockSize = 0;
+            }
+        }
+
+        // Reports whether memory is allocated.
+        bool allocated() const noexcept
+        {
+            return states != nullptr;
+        }
+
+        // Accesses the state byte of a slot.
+        uint8_t& state(size_t idx) noexcept
+        {
+            return states[idx];
+        }
+        uint8_t state(size_t idx) const noexcept
+        {
+            return states[idx];
+        }
+        // Accesses the key of a slot.
+        K& key(size_t idx) noexcept
+        {
+            return keys[idx];
+        }
+        const K& key(size_t idx) const noexcept
+        {
+            return keys[idx];
+        }
+        // Accesses the value of a slot.
+        V& value(size_t idx) noexcept
+        {
+            return values[idx];
+        }
+        const V& value(size_t idx) const noexcept
+        {
+            return values[idx];
+        }
+
+        // Exchanges the table memory with another storage.
+        void swap(storage& other) noexcept
+        {
+            std::swap(states, other.states);
+            std::swap(keys, other.keys);
+            std::swap(values, other.values);
+            std::swap(blockSize, other.blockSize);
+        }
+
+    private:
+        static size_t alignUp(size_t value, size_t alignment) noexcept
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+    private:
+        uint8_t *states{nullptr};
+        K *keys{nullptr};
+        V *values{nullptr};
+        size_t blockSize{0};
+    };
+};
+
 // Stores key-value pairs in a fixed-size open-addressed hash table.
-template<typename K, typename V, typename HashFn = static_hash_map_default_hash<K>>
+// Layout selects how slots are arranged in memory, see hash_map_layout_interleaved and hash_map_layout_split.
+// With transparent HashFn and KeyEqual functors, find/contains/erase also accept other key types.
+template<typename K, typename V, typename HashFn = static_hash_map_default_hash<K>,
+         typename Layout = hash_map_layout_interleaved, typename KeyEqual = static_hash_map_default_equal<K>>
 class static_hash_map
 {
 private:
     typedef enum State_e : uint8_t {
         EMPTY = 0,
         OCCUPIED = 1,
-        TOMBSTONE = 2
+        TOMBSTONE = 2,
+        REHASHING = 3 // Holds an entry not placed yet, only seen while purging tombstones
     } State_t;
 
-    typedef struct Entry_s {
-        K key;
-        V value;
-        State_t state;
-    } Entry_t;
+    typedef typename Layout::template storage<K, V> storage_t;
+
+    static_assert(std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>,
+                  "static_hash_map requires nothrow move constructible keys and values.");
+
+public:
+    // Bytes of table memory taken by each slot.
+    static constexpr size_t bytes_per_slot = storage_t::bytes_per_slot;
 
 public:
     // Creates an empty map with no allocated table.
     static_hash_map() noexcept = default;
     static_hash_map(const static_hash_map&) = delete;
     // Transfers ownership of the allocated hash table.
-    static_hash_map(static_hash_map&& other) noexcept : table(other.table), tableSize(other.tableSize), count(other.count),
+    static_hash_map(static_hash_map&& other) noexcept : tableSize(other.tableSize), count(other.count),
                                                         tombstones(other.tombstones)
     {
-        other.table = nullptr;
+        slots.swap(other.slots);
         other.tableSize = 0;
         other.count = 0;
         other.tombstones = 0;
@@ -68,12 +347,11 @@ public:
         if (this != &other) {
             deinit();
 
-            table = other.table;
+            slots.swap(other.slots);
             tableSize = other.tableSize;
             count = other.count;
             tombstones = other.tombstones;
 
-            other.table = nullptr;
             other.tableSize = 0;
             other.count = 0;
             other.tombstones = 0;
@@ -88,28 +366,26 @@ public:
             return ESP_ERR_INVALID_ARG;
         }
 
-        table = (Entry_t *)malloc(_tableSize * sizeof(Entry_t));
-        if (!table) {
+        if (!slots.allocate(_tableSize)) {
             return ESP_ERR_NO_MEM;
         }
         tableSize = _tableSize;
 
         for (size_t i = 0; i < tableSize; i++) {
-            table[i].state = EMPTY;
+            slots.state(i) = EMPTY;
         }
 
         // Done
         return ESP_OK;
     }
 
-    // Releases the allocated table and resets the map state.
+    // Destroys all entries, releases the allocated table and resets the map state.
     void deinit() noexcept
     {
-        if (table) {
-            memset(table, 0, tableSize * sizeof(Entry_t));
-            free(table);
-            table = nullptr;
+        if (slots.allocated()) {
+            clear();
         }
+        slots.release(tableSize);
         tableSize = 0;
         count = 0;
         tombstones = 0;
@@ -121,111 +397,115 @@ public:
         deinit();
     }
 
+    // Result of try_emplace() and emplace().
+    typedef struct insert_result_s {
+        V* value;      // nullptr if the table is full
+        bool inserted; // true if a new entry was created
+    } insert_result_t;
+
     // Inserts a new key or updates the value of an existing key.
     V* insert(const K& key, const V& value, bool* inserted = nullptr) noexcept
     {
-        size_t idx = getHash(key) % tableSize;
-        size_t start = idx;
-        size_t firstTombstone = tableSize; // Invalid index
+        return insertOrAssign(key, value, inserted);
+    }
 
-        if (inserted) {
-            *inserted = false;
-        }
+    // Inserts a new key or updates the value of an existing key, moving the value into the table.
+    V* insert(const K& key, V&& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(key, std::move(value), inserted);
+    }
 
-        do {
-            if (table[idx].state == EMPTY) {
-                if (count >= tableSize) {
-                    return nullptr;
-                }
+    // Inserts a new key or updates the value of an existing key, moving the key into the table.
+    // The key is left untouched if it already exists.
+    V* insert(K&& key, const V& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(std::move(key), value, inserted);
+    }
 
-                // Use tombstone slot if we found one earlier
-                if (firstTombstone != tableSize) {
-                    idx = firstTombstone;
-                    tombstones -= 1;
-                }
-                table[idx].key = key;
-                table[idx].value = value;
-                table[idx].state = OCCUPIED;
-                count += 1;
-                if (inserted) {
-                    *inserted = true;
-                }
-                return &table[idx].value;
-            }
-            if (table[idx].state == TOMBSTONE && firstTombstone == tableSize) {
-                firstTombstone = idx; // Remember first tombstone
-            }
-            if (table[idx].state == OCCUPIED && table[idx].key == key) {
-                table[idx].value = value; // Update existing
-                return &table[idx].value;
-            }
-            if ((++idx) >= tableSize) {
-                idx = 0;
-            }
+    // Inserts a new key or updates the value of an existing key, moving both into the table.
+    // The key is left untouched if it already exists.
+    V* insert(K&& key, V&& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(std::move(key), std::move(value), inserted);
+    }
+
+    // Constructs the value in place from args if the key is not present yet. An existing value is left
+    // untouched and args are not consumed.
+    template <class KArg, class... Args>
+    insert_result_t try_emplace(KArg&& key, Args&&... args) noexcept
+    {
+        static_assert(std::is_nothrow_constructible_v<V, Args...>, "try_emplace requires V(args...) to be nothrow constructible.");
+
+        bool found;
+        size_t idx = findInsertSlot(key, found);
+
+        if (found) {
+            return {&slots.value(idx), false};
         }
-        while (idx != start);
+        if (idx == tableSize) {
+            return {nullptr, false};
+        }
+        return {constructAt(idx, std::forward<KArg>(key), std::forward<Args>(args)...), true};
+    }
 
-        // Done
-        return nullptr;
+    // Constructs the value in place from args, replacing the value of an existing key.
+    template <class KArg, class... Args>
+    insert_result_t emplace(KArg&& key, Args&&... args) noexcept
+    {
+        static_assert(std::is_nothrow_constructible_v<V, Args...>, "emplace requires V(args...) to be nothrow constructible.");
+
+        bool found;
+        size_t idx = findInsertSlot(key, found);
+
+        if (found) {
+            slots.value(idx).~V();
+            ::new (static_cast<void*>(&slots.value(idx))) V(std::forward<Args>(args)...);
+            return {&slots.value(idx), false};
+        }
+        if (idx == tableSize) {
+            return {nullptr, false};
+        }
+        return {constructAt(idx, std::forward<KArg>(key), std::forward<Args>(args)...), true};
     }
 
     // Returns the value pointer for a key or nullptr if not found.
     V* find(const K& key) noexcept
     {
-        size_t idx = getHash(key) % tableSize;
-        size_t start = idx;
-
-        do {
-            if (table[idx].state == EMPTY) {
-                return nullptr;
-            }
-            if (table[idx].state == OCCUPIED && table[idx].key == key) {
-                return &table[idx].value;
-            }
-            if ((++idx) >= tableSize) {
-                idx = 0;
-            }
-        }
-        while (idx != start);
+        return findImpl(key);
+    }
 
-        // Not found
-        return nullptr;
+    // Returns the value pointer for a key of another type, such as a C string in a string-keyed map,
+    // without building a temporary K. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    V* find(const Q& key) noexcept
+    {
+        return findImpl(key);
     }
 
     // Reports whether the requested key exists in the map.
     bool contains(const K& key) noexcept
     {
-        return find(key) != nullptr;
+        return findImpl(key) != nullptr;
+    }
+
+    // Reports whether a key of another type exists in the map. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool contains(const Q& key) noexcept
+    {
+        return findImpl(key) != nullptr;
     }
 
     // Removes a key and leaves a tombstone for probing continuity.
     bool erase(const K& key) noexcept
     {
-        size_t idx = getHash(key) % tableSize;
-        size_t start = idx;
-
-        do {
-            if (table[idx].state == EMPTY) {
-                return false;
-            }
-            if (table[idx].state == OCCUPIED && table[idx].key == key) {
-                table[idx].state = TOMBSTONE;
-                memset(&table[idx].key, 0, sizeof(K));
-                memset(&table[idx].value, 0, sizeof(V));
-
-                count -= 1;
-                tombstones += 1;
-                rehashIfNeeded(false);
-                return true;
-            }
-            if ((++idx) >= tableSize) {
-                idx = 0;
-            }
-        }
-        while (idx != start);
+        return eraseImpl(key);
+    }
 
-        // Not found
-        return false;
+    // Removes a key of another type. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool erase(const Q& key) noexcept
+    {
+        return eraseImpl(key);
     }
 
     // Returns the number of occupied entries.
@@ -240,19 +520,23 @@ public:
         return count == 0;
     }
 
-    // Removes all entries without releasing the table allocation.
+    // Destroys all entries without releasing the table allocation.
     void clear() noexcept
     {
         for (size_t i = 0; i < tableSize; i += 1) {
-            table[i].state = EMPTY;
-            memset(&table[i].key, 0, sizeof(K));
-            memset(&table[i].value, 0, sizeof(V));
+            if (slots.state(i) == OCCUPIED) {
+                destroyAt(i, EMPTY);
+            }
+            else {
+                slots.state(i) = EMPTY;
+            }
         }
         count = 0;
         tombstones = 0;
     }
 
-    // Rebuilds the table to remove accumulated tombstones.
+    // Rebuilds the table to remove accumulated tombstones. Linear with a well-spread hash, quadratic in the
+    // table size in the worst case (heavily clustered keys).
     void compact() noexcept
     {
         if (tombstones > 0) {
@@ -260,6 +544,65 @@ public:
         }
     }
 
+    // Snapshot of the table occupancy and clustering returned by stats().
+    typedef struct stats_s {
+        size_t size;             // Occupied slots
+        size_t capacity;         // Table slots
+        size_t tombstones;       // Erased slots not reclaimed yet
+        float loadFactor;        // size / capacity
+        float tombstoneRatio;    // tombstones / capacity
+        size_t maxProbeLength;   // Slots a lookup of the worst placed key inspects
+        float avgProbeLength;    // Slots a successful lookup inspects on average
+        size_t bytesUsed;        // Table memory
+        uint32_t lookups;        // Lookups since the last reset_probe_stats(), 0 without LIGHTSTD_HASH_MAP_PROBE_STATS
+        uint32_t probes;         // Slots inspected by those lookups, 0 without LIGHTSTD_HASH_MAP_PROBE_STATS
+    } stats_t;
+
+    // Gathers occupancy and probe length statistics. The probe lengths come from the distance of every
+    // entry to its home slot, so this hashes every key and takes O(capacity) time.
+    stats_t stats() const noexcept
+    {
+        stats_t st = {};
+        size_t totalProbes = 0;
+
+        st.size = count;
+        st.capacity = tableSize;
+        st.tombstones = tombstones;
+        st.bytesUsed = tableSize * bytes_per_slot;
+        if (tableSize > 0) {
+            st.loadFactor = (float)count / (float)tableSize;
+            st.tombstoneRatio = (float)tombstones / (float)tableSize;
+        }
+        for (size_t i = 0; i < tableSize; i++) {
+            if (slots.state(i) == OCCUPIED) {
+                size_t home = getHash(slots.key(i));
+                size_t probeLength = ((i >= home) ? i - home : i + tableSize - home) + 1;
+
+                totalProbes += probeLength;
+                if (probeLength > st.maxProbeLength) {
+                    st.maxProbeLength = probeLength;
+                }
+            }
+        }
+        if (count > 0) {
+            st.avgProbeLength = (float)totalProbes / (float)count;
+        }
+#if LIGHTSTD_HASH_MAP_PROBE_STATS
+        st.lookups = lookupCount;
+        st.probes = probeCount;
+#endif // LIGHTSTD_HASH_MAP_PROBE_STATS
+        return st;
+    }
+
+    // Resets the lookup and probe counters reported by stats().
+    void reset_probe_stats() noexcept
+    {
+#if LIGHTSTD_HASH_MAP_PROBE_STATS
+        lookupCount = 0;
+        probeCount = 0;
+#endif // LIGHTSTD_HASH_MAP_PROBE_STATS
+    }
+
 public:
     typedef struct key_value_s {
         K& key;
@@ -276,12 +619,12 @@ public:
     class iterator
     {
     public:
-        // Creates an iterator over the allocated table range.
-        iterator(Entry_t* p, Entry_t* e) noexcept : ptr(p), end(e)
+        // Creates an iterator positioned at the first occupied slot at or after idx.
+        iterator(storage_t* s, size_t i, size_t n) noexcept : slots(s), idx(i), size(n)
         {
             // Skip to first occupied slot
-            while (ptr != end && ptr->state != OCCUPIED) {
-                ptr += 1;
+            while (idx < size && slots->state(idx) != OCCUPIED) {
+                idx += 1;
             }
         }
         iterator(const iterator&) noexcept = default;
@@ -295,11 +638,11 @@ public:
         // Advances to the next occupied slot.
         iterator& operator++() noexcept
         {
-            if (ptr != end) {
-                ptr += 1;
+            if (idx < size) {
+                idx += 1;
                 // Skip non-occupied slots
-                while (ptr != end && ptr->state != OCCUPIED) {
-                    ptr += 1;
+                while (idx < size && slots->state(idx) != OCCUPIED) {
+                    idx += 1;
                 }
             }
             return *this;
@@ -308,28 +651,29 @@ public:
         // Compares iterator positions.
         bool operator!=(const iterator& other) const noexcept
         {
-            return ptr != other.ptr;
+            return idx != other.idx;
         }
 
         // Returns references to the current key and value.
         key_value_t operator*() noexcept
         {
-            return {ptr->key, ptr->value};
+            return {slots->key(idx), slots->value(idx)};
         }
 
     private:
-        Entry_t* ptr;
-        Entry_t* end;
+        storage_t* slots;
+        size_t idx;
+        size_t size;
     };
 
     class const_iterator
     {
     public:
-        // Creates a const iterator over the allocated table range.
-        const_iterator(const Entry_t* p, const Entry_t* e) noexcept : ptr(p), end(e)
+        // Creates a const iterator positioned at the first occupied slot at or after idx.
+        const_iterator(const storage_t* s, size_t i, size_t n) noexcept : slots(s), idx(i), size(n)
         {
-            while (ptr != end && ptr->state != OCCUPIED) {
-                ptr += 1;
+            while (idx < size && slots->state(idx) != OCCUPIED) {
+                idx += 1;
             }
         }
         const_iterator(const const_iterator&) noexcept = default;
@@ -343,10 +687,10 @@ public:
         // Advances to the next occupied slot.
         const_iterator& operator++() noexcept
         {
-            if (ptr != end) {
-                ptr += 1;
-                while (ptr != end && ptr->state != OCCUPIED) {
-                    ptr += 1;
+            if (idx < size) {
+                idx += 1;
+                while (idx < size && slots->state(idx) != OCCUPIED) {
+                    idx += 1;
                 }
             }
             return *this;
@@ -355,67 +699,192 @@ public:
         // Compares iterator positions.
         bool operator!=(const const_iterator& other) const noexcept
         {
-            return ptr != other.ptr;
+            return idx != other.idx;
         }
 
         // Returns const references to the current key and value.
         const_key_value_t operator*() const noexcept
         {
-            return {ptr->key, ptr->value};
+            return {slots->key(idx), slots->value(idx)};
         }
 
     private:
-        const Entry_t* ptr;
-        const Entry_t* end;
+        const storage_t* slots;
+        size_t idx;
+        size_t size;
     };
 
 public:
     // Iteration follows internal table/probe order, not key order, matching std::unordered_map rather than std::map.
     iterator begin() noexcept
     {
-        return iterator(getTableBegin(), getTableEnd());
+        return iterator(&slots, 0, tableSize);
     }
 
     // Returns an iterator one past the last table slot.
     iterator end() noexcept
     {
-        return iterator(getTableEnd(), getTableEnd());
+        return iterator(&slots, tableSize, tableSize);
     }
 
     // Returns a const iterator to the first occupied slot.
     const_iterator begin() const noexcept
     {
-        return const_iterator(getTableBegin(), getTableEnd());
+        return const_iterator(&slots, 0, tableSize);
     }
 
     // Returns a const iterator one past the last table slot.
     const_iterator end() const noexcept
     {
-        return const_iterator(getTableEnd(), getTableEnd());
+        return const_iterator(&slots, tableSize, tableSize);
     }
 
 private:
-    Entry_t* getTableBegin() noexcept
-    {
-        return table;
-    }
-
-    Entry_t* getTableEnd() noexcept
+    // Returns the slot holding key and sets found, or the slot where key would be inserted.
+    // Returns tableSize if the key is not present and there is no room left.
+    template <class Q>
+    size_t findInsertSlot(const Q& key, bool& found) noexcept
     {
-        return table ? (table + tableSize) : nullptr;
-    }
-
-    const Entry_t* getTableBegin() const noexcept
-    {
-        return table;
-    }
+        size_t idx = getHash(key);
+        size_t start = idx;
+        size_t firstTombstone = tableSize; // Invalid index
 
-    const Entry_t* getTableEnd() const noexcept
-    {
-        return table ? (table + tableSize) : nullptr;
-    }
+        found = false;
+        countLookup();
+        do {
+            countProbe();
+            if (slots.state(idx) == EMPTY) {
+                // Use tombstone slot if we found one earlier
+                return (firstTombstone != tableSize) ? firstTombstone : idx;
+            }
+            if (slots.state(idx) == TOMBSTONE && firstTombstone == tableSize) {
+                firstTombstone = idx; // Remember first tombstone
+            }
+            if (slots.state(idx) == OCCUPIED && keyEqual(slots.key(idx), key)) {
+                found = true;
+                return idx;
+            }
+            if ((++idx) >= tableSize) {
+                idx = 0;
+            }
+        }
+        while (idx != start);
+
+        // No empty slot left, but the key is not present either: reuse the first tombstone if any.
+        return firstTombstone;
+    }
+
+    template <class KArg, class VArg>
+    V* insertOrAssign(KArg&& key, VArg&& value, bool* inserted) noexcept
+    {
+        bool found;
+        size_t idx = findInsertSlot(key, found);
+
+        if (inserted) {
+            *inserted = false;
+        }
+        if (found) {
+            slots.value(idx) = std::forward<VArg>(value); // Update existing
+            return &slots.value(idx);
+        }
+        if (idx == tableSize) {
+            return nullptr;
+        }
+        if (inserted) {
+            *inserted = true;
+        }
+        return constructAt(idx, std::forward<KArg>(key), std::forward<VArg>(value));
+    }
+
+    // Constructs a new entry in a free slot.
+    template <class KArg, class... Args>
+    V* constructAt(size_t idx, KArg&& key, Args&&... args) noexcept
+    {
+        if (slots.state(idx) == TOMBSTONE) {
+            tombstones -= 1;
+        }
+        ::new (static_cast<void*>(&slots.key(idx))) K(std::forward<KArg>(key));
+        ::new (static_cast<void*>(&slots.value(idx))) V(std::forward<Args>(args)...);
+        slots.state(idx) = OCCUPIED;
+        count += 1;
+        return &slots.value(idx);
+    }
+
+    // Destroys the entry of an occupied slot and wipes its bytes.
+    void destroyAt(size_t idx, State_t newState) noexcept
+    {
+        slots.key(idx).~K();
+        slots.value(idx).~V();
+        memset(static_cast<void*>(&slots.key(idx)), 0, sizeof(K));
+        memset(static_cast<void*>(&slots.value(idx)), 0, sizeof(V));
+        slots.state(idx) = newState;
+    }
+
+    // Moves the entry of slot from into the free slot to, leaving from destroyed.
+    void moveEntry(size_t to, size_t from, State_t fromState) noexcept
+    {
+        ::new (static_cast<void*>(&slots.key(to))) K(std::move(slots.key(from)));
+        ::new (static_cast<void*>(&slots.value(to))) V(std::move(slots.value(from)));
+        slots.state(to) = OCCUPIED;
+        destroyAt(from, fromState);
+    }
+
+    template <class Q>
+    V* findImpl(const Q& key) noexcept
+    {
+        size_t idx = getHash(key);
+        size_t start = idx;
+
+        countLookup();
+        do {
+            countProbe();
+            if (slots.state(idx) == EMPTY) {
+                return nullptr;
+            }
+            if (slots.state(idx) == OCCUPIED && keyEqual(slots.key(idx), key)) {
+                return &slots.value(idx);
+            }
+            if ((++idx) >= tableSize) {
+                idx = 0;
+            }
+        }
+        while (idx != start);
+
+        // Not found
+        return nullptr;
+    }
+
+    template <class Q>
+    bool eraseImpl(const Q& key) noexcept
+    {
+        size_t idx = getHash(key);
+        size_t start = idx;
+
+        countLookup();
+        do {
+            countProbe();
+            if (slots.state(idx) == EMPTY) {
+                return false;
+            }
+            if (slots.state(idx) == OCCUPIED && keyEqual(slots.key(idx), key)) {
+                destroyAt(idx, TOMBSTONE);
+
+                count -= 1;
+                tombstones += 1;
+                rehashIfNeeded(false);
+                return true;
+            }
+            if ((++idx) >= tableSize) {
+                idx = 0;
+            }
+        }
+        while (idx != start);
+
+        // Not found
+        return false;
+    }
 
-    // Rebuild table when there are more than 25% of tombstones
+    // Purges the tombstones once they exceed 25% of the table, or always if force is set.
     void rehashIfNeeded(bool force) noexcept
     {
         if (force || tombstones > tableSize / 4) {
@@ -423,95 +892,1036 @@ private:
                 clear();
                 return;
             }
+            purgeTombstones();
+        }
+    }
 
-            // Try to allocate temporary storage for optimal rehashing
-            Entry_t* temp = (Entry_t*)malloc(count * sizeof(Entry_t));
-            if (temp) {
-                // Fast path: We have temporary storage, do optimal rehash
-                size_t i;
+    // Rebuilds the probe runs in place without tombstones. Tombstones become empty slots and every entry is
+    // flagged as REHASHING. Each flagged entry is then placed at the first slot from its home that is not
+    // final yet: it stays if that is its own slot, moves if the slot is empty, or swaps with the flagged
+    // entry found there and the one swapped in is processed next. Every step makes one slot final, so the
+    // purge hashes and moves at most tableSize entries and needs no extra memory. Final entries never move
+    // again, so the slots between the home and the position of each entry stay occupied, which is what
+    // lookups rely on.
+    // NOTE: Finding the first non-final slot walks the final run after each home, so the probing cost is the
+    //       sum of the entries' probe distances: about O(tableSize) with a well-spread hash, but O(tableSize^2)
+    //       when keys cluster or compact() runs on a nearly full table.
+    void purgeTombstones() noexcept
+    {
+        size_t i;
 
-                // Extract all occupied entries
-                size_t tempIdx = 0;
-                for (i = 0; i < tableSize; i++) {
-                    if (table[i].state == OCCUPIED) {
-                        temp[tempIdx].key = table[i].key;
-                        temp[tempIdx].value = table[i].value;
-                        tempIdx++;
-                    }
-                }
+        for (i = 0; i < tableSize; i++) {
+            uint8_t &state = slots.state(i);
 
-                // Clear table
-                clear();
+            state = (state == OCCUPIED) ? REHASHING : EMPTY;
+        }
 
-                // Re-insert all entries
-                for (i = 0; i < tempIdx; i++) {
-                    insert(temp[i].key, temp[i].value);
-                }
+        for (i = 0; i < tableSize; i++) {
+            while (slots.state(i) == REHASHING) {
+                size_t target = getHash(slots.key(i));
 
-                memset(temp, 0, count * sizeof(Entry_t));
-                free(temp);
-            }
-            else {
-                // Slow path: No memory available, do in-place redistribution
-                size_t i, pass;
-
-                // In-place rehashing using multi-pass redistribution
-                for (pass = 0; pass < 2; pass++) {
-                    for (i = 0; i < tableSize; i++) {
-                        if (table[i].state == OCCUPIED) {
-                            size_t idealIdx = getHash(table[i].key);
-
-                            // If this entry is not in its ideal position
-                            if (idealIdx != i) {
-                                size_t targetIdx = idealIdx;
-
-                                // Find where this entry should go
-                                while (targetIdx != i) {
-                                    if (table[targetIdx].state != OCCUPIED) {
-                                        // Found an empty/tombstone slot, move entry here
-                                        table[targetIdx].key = table[i].key;
-                                        table[targetIdx].value = table[i].value;
-                                        table[targetIdx].state = OCCUPIED;
-
-                                        table[i].state = TOMBSTONE;
-                                        memset(&table[i].key, 0, sizeof(K));
-                                        memset(&table[i].value, 0, sizeof(V));
-
-                                        break;
-                                    }
-                                    // Slot occupied, try next
-                                    if ((++targetIdx) >= tableSize) {
-                                        targetIdx = 0;
-                                    }
-                                }
-                            }
-                        }
+                while (slots.state(target) == OCCUPIED) {
+                    if ((++target) >= tableSize) {
+                        target = 0;
                     }
                 }
 
-                // Clean up all tombstones
-                for (i = 0; i < tableSize; i++) {
-                    if (table[i].state == TOMBSTONE) {
-                        table[i].state = EMPTY;
-                    }
+                if (target == i) {
+                    slots.state(i) = OCCUPIED;
+                }
+                else if (slots.state(target) == EMPTY) {
+                    moveEntry(target, i, EMPTY);
+                }
+                else {
+                    swapEntries(i, target);
+                    slots.state(target) = OCCUPIED;
                 }
             }
-
-            tombstones = 0;
         }
+
+        tombstones = 0;
+    }
+
+    // Exchanges the entries of two slots holding live entries. Only needs K and V to be move constructible.
+    void swapEntries(size_t a, size_t b) noexcept
+    {
+        K tmpKey(std::move(slots.key(a)));
+        V tmpValue(std::move(slots.value(a)));
+
+        slots.key(a).~K();
+        slots.value(a).~V();
+        ::new (static_cast<void*>(&slots.key(a))) K(std::move(slots.key(b)));
+        ::new (static_cast<void*>(&slots.value(a))) V(std::move(slots.value(b)));
+        slots.key(b).~K();
+        slots.value(b).~V();
+        ::new (static_cast<void*>(&slots.key(b))) K(std::move(tmpKey));
+        ::new (static_cast<void*>(&slots.value(b))) V(std::move(tmpValue));
     }
 
-    size_t getHash(const K& key)
+    template <class Q>
+    size_t getHash(const Q& key) const
     {
         return hasher(key) % tableSize;
     }
 
+    void countLookup() noexcept
+    {
+#if LIGHTSTD_HASH_MAP_PROBE_STATS
+        lookupCount += 1;
+#endif // LIGHTSTD_HASH_MAP_PROBE_STATS
+    }
+
+    void countProbe() noexcept
+    {
+#if LIGHTSTD_HASH_MAP_PROBE_STATS
+        probeCount += 1;
+#endif // LIGHTSTD_HASH_MAP_PROBE_STATS
+    }
+
 private:
     HashFn hasher;
-    Entry_t *table{nullptr};
+    KeyEqual keyEqual;
+    storage_t slots;
     size_t tableSize{0};
     size_t count{0};
     size_t tombstones{0};
+#if LIGHTSTD_HASH_MAP_PROBE_STATS
+    uint32_t lookupCount{0};
+    uint32_t probeCount{0};
+#endif // LIGHTSTD_HASH_MAP_PROBE_STATS
+};
+
+// Fixed-size open-addressed hash map using Robin Hood linear probing. It has the same API as static_hash_map.
+// A packed array of 1-byte probe distances is scanned before any key is touched. A lookup stops as soon as
+// it meets an entry closer to its home slot than the key being searched would be.
+// Erasing shifts the rest of the probe run back by one slot, so there are no tombstones and lookups do not
+// degrade with churn. Probe distances are limited to 255; insert() fails beyond that, which only happens
+// on pathological hash functions.
+// Keys and values are constructed in place and move when entries are shifted.
+// NOTE: Pointers returned by insert() and find() are invalidated by any later insert() or erase().
+template<typename K, typename V, typename HashFn = static_hash_map_default_hash<K>,
+         typename KeyEqual = static_hash_map_default_equal<K>>
+class static_robin_hood_map
+{
+private:
+    typedef struct Entry_s {
+        K key;
+        V value;
+    } Entry_t;
+
+    static_assert(std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>,
+                  "static_robin_hood_map requires nothrow move constructible keys and values.");
+
+    // Distance markers are 1-based so that zero can flag an empty slot.
+    static constexpr uint8_t EMPTY = 0;
+    static constexpr size_t MAX_DISTANCE = 255;
+
+public:
+    // Creates an empty map with no allocated table.
+    static_robin_hood_map() noexcept = default;
+    static_robin_hood_map(const static_robin_hood_map&) = delete;
+    // Transfers ownership of the allocated hash table.
+    static_robin_hood_map(static_robin_hood_map&& other) noexcept : table(other.table), distances(other.distances),
+                                                                    tableSize(other.tableSize), count(other.count)
+    {
+        other.table = nullptr;
+        other.distances = nullptr;
+        other.tableSize = 0;
+        other.count = 0;
+    }
+
+    // Releases the allocated hash table.
+    ~static_robin_hood_map()
+    {
+        deinit();
+    }
+
+    static_robin_hood_map& operator=(const static_robin_hood_map&) = delete;
+    // Transfers ownership of the allocated hash table.
+    static_robin_hood_map& operator=(static_robin_hood_map&& other) noexcept
+    {
+        if (this != &other) {
+            deinit();
+
+            table = other.table;
+            distances = other.distances;
+            tableSize = other.tableSize;
+            count = other.count;
+
+            other.table = nullptr;
+            other.distances = nullptr;
+            other.tableSize = 0;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    // Allocates a fixed-size table for the requested number of slots.
+    esp_err_t init(size_t _tableSize) noexcept
+    {
+        if (_tableSize < 1 || _tableSize > SIZE_MAX / (sizeof(Entry_t) + 1)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        // Entries and distance markers share a single allocation.
+        table = (Entry_t *)malloc(_tableSize * (sizeof(Entry_t) + 1));
+        if (!table) {
+            return ESP_ERR_NO_MEM;
+        }
+        distances = reinterpret_cast<uint8_t*>(table + _tableSize);
+        memset(distances, EMPTY, _tableSize);
+        tableSize = _tableSize;
+
+        // Done
+        return ESP_OK;
+    }
+
+    // Destroys all entries, releases the allocated table and resets the map state.
+    void deinit() noexcept
+    {
+        if (table) {
+            clear();
+            free(table);
+            table = nullptr;
+            distances = nullptr;
+        }
+        tableSize = 0;
+        count = 0;
+    }
+
+    // Releases the allocated table and resets the map state.
+    void done() noexcept
+    {
+        deinit();
+    }
+
+    // Inserts a new key or updates the value of an existing key.
+    V* insert(const K& key, const V& value, bool* inserted = nullptr) noexcept
+    {
+        size_t idx, dist, last;
+
+        if (inserted) {
+            *inserted = false;
+        }
+        if (!table) {
+            return nullptr;
+        }
+
+        if (lookup(key, idx, dist)) {
+            table[idx].value = value; // Update existing
+            return &table[idx].value;
+        }
+        if (count >= tableSize || dist > MAX_DISTANCE) {
+            return nullptr;
+        }
+
+        // Every entry from idx up to the next empty slot moves one slot forward, so make sure
+        // none of them would exceed the maximum distance first.
+        last = idx;
+        while (distances[last] != EMPTY) {
+            if (distances[last] == MAX_DISTANCE) {
+                return nullptr;
+            }
+            last = next(last);
+        }
+
+        // Copy the arguments before shifting, they may reference entries that are about to move.
+        K keyCopy(key);
+        V valueCopy(value);
+
+        while (last != idx) {
+            size_t prev = (last > 0) ? last - 1 : tableSize - 1;
+
+            ::new (static_cast<void*>(&table[last].key)) K(std::move(table[prev].key));
+            ::new (static_cast<void*>(&table[last].value)) V(std::move(table[prev].value));
+            distances[last] = distances[prev] + 1;
+            destroyEntry(prev);
+            last = prev;
+        }
+
+        ::new (static_cast<void*>(&table[idx].key)) K(std::move(keyCopy));
+        ::new (static_cast<void*>(&table[idx].value)) V(std::move(valueCopy));
+        distances[idx] = (uint8_t)dist;
+        count += 1;
+        if (inserted) {
+            *inserted = true;
+        }
+        return &table[idx].value;
+    }
+
+    // Returns the value pointer for a key or nullptr if not found.
+    V* find(const K& key) noexcept
+    {
+        return findImpl(key);
+    }
+
+    // Returns the value pointer for a key of another type without building a temporary K.
+    // Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    V* find(const Q& key) noexcept
+    {
+        return findImpl(key);
+    }
+
+    // Reports whether the requested key exists in the map.
+    bool contains(const K& key) noexcept
+    {
+        return findImpl(key) != nullptr;
+    }
+
+    // Reports whether a key of another type exists in the map. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool contains(const Q& key) noexcept
+    {
+        return findImpl(key) != nullptr;
+    }
+
+    // Removes a key and shifts the rest of its probe run back by one slot.
+    bool erase(const K& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Removes a key of another type. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool erase(const Q& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Returns the number of occupied entries.
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    // Reports whether the map contains no entries.
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    // Removes all entries without releasing the table allocation.
+    void clear() noexcept
+    {
+        for (size_t i = 0; i < tableSize; i++) {
+            if (distances[i] != EMPTY) {
+                destroyEntry(i);
+            }
+        }
+        count = 0;
+    }
+
+    // No-op kept for API compatibility with static_hash_map, there are never tombstones to purge.
+    void compact() noexcept
+    {
+    }
+
+public:
+    typedef struct key_value_s {
+        K& key;
+        V& value;
+    } key_value_t;
+
+    // Exposes a read-only key-value view when iterating a const map.
+    typedef struct const_key_value_s {
+        const K& key;
+        const V& value;
+    } const_key_value_t;
+
+public:
+    class iterator
+    {
+    public:
+        // Creates an iterator positioned at the first occupied slot at or after idx.
+        iterator(Entry_t* t, const uint8_t* d, size_t i, size_t n) noexcept : table(t), distances(d), idx(i), size(n)
+        {
+            while (idx < size && distances[idx] == EMPTY) {
+                idx += 1;
+            }
+        }
+
+        // Advances to the next occupied slot.
+        iterator& operator++() noexcept
+        {
+            if (idx < size) {
+                idx += 1;
+                while (idx < size && distances[idx] == EMPTY) {
+                    idx += 1;
+                }
+            }
+            return *this;
+        }
+
+        // Compares iterator positions.
+        bool operator!=(const iterator& other) const noexcept
+        {
+            return idx != other.idx;
+        }
+
+        // Returns references to the current key and value.
+        key_value_t operator*() noexcept
+        {
+            return {table[idx].key, table[idx].value};
+        }
+
+    private:
+        Entry_t* table;
+        const uint8_t* distances;
+        size_t idx;
+        size_t size;
+    };
+
+    class const_iterator
+    {
+    public:
+        // Creates a const iterator positioned at the first occupied slot at or after idx.
+        const_iterator(const Entry_t* t, const uint8_t* d, size_t i, size_t n) noexcept : table(t), distances(d), idx(i),
+                                                                                          size(n)
+        {
+            while (idx < size && distances[idx] == EMPTY) {
+                idx += 1;
+            }
+        }
+
+        // Advances to the next occupied slot.
+        const_iterator& operator++() noexcept
+        {
+            if (idx < size) {
+                idx += 1;
+                while (idx < size && distances[idx] == EMPTY) {
+                    idx += 1;
+                }
+            }
+            return *this;
+        }
+
+        // Compares iterator positions.
+        bool operator!=(const const_iterator& other) const noexcept
+        {
+            return idx != other.idx;
+        }
+
+        // Returns const references to the current key and value.
+        const_key_value_t operator*() const noexcept
+        {
+            return {table[idx].key, table[idx].value};
+        }
+
+    private:
+        const Entry_t* table;
+        const uint8_t* distances;
+        size_t idx;
+        size_t size;
+    };
+
+public:
+    // Iteration follows internal table/probe order, not key order.
+    iterator begin() noexcept
+    {
+        return iterator(table, distances, 0, tableSize);
+    }
+
+    // Returns an iterator one past the last table slot.
+    iterator end() noexcept
+    {
+        return iterator(table, distances, tableSize, tableSize);
+    }
+
+    // Returns a const iterator to the first occupied slot.
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(table, distances, 0, tableSize);
+    }
+
+    // Returns a const iterator one past the last table slot.
+    const_iterator end() const noexcept
+    {
+        return const_iterator(table, distances, tableSize, tableSize);
+    }
+
+private:
+    size_t next(size_t idx) const noexcept
+    {
+        return ((++idx) < tableSize) ? idx : 0;
+    }
+
+    template <class Q>
+    V* findImpl(const Q& key) noexcept
+    {
+        size_t idx, dist;
+
+        return lookup(key, idx, dist) ? &table[idx].value : nullptr;
+    }
+
+    template <class Q>
+    bool eraseImpl(const Q& key) noexcept
+    {
+        size_t idx, dist;
+
+        if (!lookup(key, idx, dist)) {
+            return false;
+        }
+
+        destroyEntry(idx);
+        for (size_t nextIdx = next(idx); distances[nextIdx] > 1; nextIdx = next(nextIdx)) {
+            ::new (static_cast<void*>(&table[idx].key)) K(std::move(table[nextIdx].key));
+            ::new (static_cast<void*>(&table[idx].value)) V(std::move(table[nextIdx].value));
+            distances[idx] = distances[nextIdx] - 1;
+            destroyEntry(nextIdx);
+            idx = nextIdx;
+        }
+        count -= 1;
+        return true;
+    }
+
+    // Locates key. On a miss, idx and dist report the slot and distance a new entry would take.
+    template <class Q>
+    bool lookup(const Q& key, size_t& idx, size_t& dist) const noexcept
+    {
+        dist = 1;
+        if (!table) {
+            return false;
+        }
+
+        idx = hasher(key) % tableSize;
+        for (;;) {
+            size_t d = distances[idx];
+
+            // Entries are ordered by distance: a closer one means key would have been placed already.
+            if (d < dist) {
+                return false;
+            }
+            if (d == dist && keyEqual(table[idx].key, key)) {
+                return true;
+            }
+            idx = next(idx);
+            dist += 1;
+        }
+    }
+
+    void destroyEntry(size_t idx) noexcept
+    {
+        table[idx].key.~K();
+        table[idx].value.~V();
+        distances[idx] = EMPTY;
+    }
+
+private:
+    HashFn hasher;
+    KeyEqual keyEqual;
+    Entry_t *table{nullptr};
+    uint8_t *distances{nullptr};
+    size_t tableSize{0};
+    size_t count{0};
+};
+
+// Open-addressed hash map that grows on demand. Capacity is always a power of two so slots are
+// selected with a mask, and the table doubles once the load exceeds maxLoadPercent.
+// Erasing shifts the following entries of the probe run backwards instead of leaving tombstones,
+// so lookups never slow down because of churn.
+// Keys and values are constructed in place and moved when the table grows. With transparent HashFn and
+// KeyEqual functors, find/contains/erase also accept other key types.
+// NOTE: Pointers returned by insert() and find() are invalidated by any later insertion.
+// NOTE: lightstd::hash_map does NOT throw exceptions on purpose.
+template<typename K, typename V, typename HashFn = static_hash_map_default_hash<K>,
+         typename KeyEqual = static_hash_map_default_equal<K>>
+class hash_map
+{
+private:
+    typedef enum State_e : uint8_t {
+        EMPTY = 0,
+        OCCUPIED = 1
+    } State_t;
+
+    typedef struct Entry_s {
+        K key;
+        V value;
+        State_t state;
+    } Entry_t;
+
+    static_assert(std::is_nothrow_move_constructible_v<K> && std::is_nothrow_move_constructible_v<V>,
+                  "hash_map requires nothrow move constructible keys and values.");
+
+public:
+    // Creates an empty map. No memory is allocated until the first insertion.
+    // maxLoadPercent is clamped to [10, 95].
+    hash_map(IAllocator *_alloc = nullptr, uint8_t _maxLoadPercent = 75) noexcept
+    {
+        alloc = _alloc ? _alloc : IAllocator::getDefault();
+        maxLoadPercent = (_maxLoadPercent < 10) ? 10 : ((_maxLoadPercent > 95) ? 95 : _maxLoadPercent);
+    }
+
+    hash_map(const hash_map&) = delete;
+    // Transfers ownership of the allocated hash table.
+    hash_map(hash_map&& other) noexcept : hasher(std::move(other.hasher)), keyEqual(std::move(other.keyEqual)),
+                                          alloc(other.alloc), table(other.table), tableSize(other.tableSize),
+                                          count(other.count), maxLoadPercent(other.maxLoadPercent)
+    {
+        other.table = nullptr;
+        other.tableSize = 0;
+        other.count = 0;
+    }
+
+    // Destroys all entries and releases the table.
+    ~hash_map() noexcept
+    {
+        release();
+    }
+
+    hash_map& operator=(const hash_map&) = delete;
+    // Transfers ownership of the allocated hash table.
+    hash_map& operator=(hash_map&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+
+            hasher = std::move(other.hasher);
+            keyEqual = std::move(other.keyEqual);
+            alloc = other.alloc;
+            table = other.table;
+            tableSize = other.tableSize;
+            count = other.count;
+            maxLoadPercent = other.maxLoadPercent;
+
+            other.table = nullptr;
+            other.tableSize = 0;
+            other.count = 0;
+        }
+        return *this;
+    }
+
+    // Grows the table so that it can hold at least entries keys without rehashing.
+    [[nodiscard]] bool reserve(size_t entries) noexcept
+    {
+        size_t newSize = tableSize ? tableSize : MIN_TABLE_SIZE;
+
+        while (!fits(entries, newSize)) {
+            if (newSize > SIZE_MAX / 2 / sizeof(Entry_t)) {
+                return false;
+            }
+            newSize *= 2;
+        }
+        return (newSize == tableSize) ? true : rehash(newSize);
+    }
+
+    // Inserts a new key or updates the value of an existing key.
+    // Returns nullptr if the table needed to grow and memory is exhausted.
+    V* insert(const K& key, const V& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(key, value, inserted);
+    }
+
+    // Inserts a new key or updates the value of an existing key, moving the value into the table.
+    V* insert(const K& key, V&& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(key, std::move(value), inserted);
+    }
+
+    // Inserts a new key or updates the value of an existing key, moving the key into the table.
+    // The key is left untouched if it already exists.
+    V* insert(K&& key, const V& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(std::move(key), value, inserted);
+    }
+
+    // Inserts a new key or updates the value of an existing key, moving both into the table.
+    // The key is left untouched if it already exists.
+    V* insert(K&& key, V&& value, bool* inserted = nullptr) noexcept
+    {
+        return insertOrAssign(std::move(key), std::move(value), inserted);
+    }
+
+    // Returns the value pointer for a key or nullptr if not found.
+    V* find(const K& key) noexcept
+    {
+        return findImpl(key);
+    }
+
+    // Returns the read-only value pointer for a key or nullptr if not found.
+    const V* find(const K& key) const noexcept
+    {
+        return const_cast<hash_map*>(this)->findImpl(key);
+    }
+
+    // Returns the value pointer for a key of another type, such as a C string in a string-keyed map,
+    // without building a temporary K. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    V* find(const Q& key) noexcept
+    {
+        return findImpl(key);
+    }
+
+    // Returns the read-only value pointer for a key of another type. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    const V* find(const Q& key) const noexcept
+    {
+        return const_cast<hash_map*>(this)->findImpl(key);
+    }
+
+    // Reports whether the requested key exists in the map.
+    bool contains(const K& key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    // Reports whether a key of another type exists in the map. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool contains(const Q& key) const noexcept
+    {
+        return find(key) != nullptr;
+    }
+
+    // Removes a key and closes the gap in its probe run.
+    bool erase(const K& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Removes a key of another type. Needs transparent HashFn and KeyEqual.
+    template <class Q, detail::enable_transparent_lookup_t<K, Q, HashFn, KeyEqual> = 0>
+    bool erase(const Q& key) noexcept
+    {
+        return eraseImpl(key);
+    }
+
+    // Returns the number of occupied entries.
+    size_t size() const noexcept
+    {
+        return count;
+    }
+
+    // Reports whether the map contains no entries.
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+
+    // Returns the number of slots in the table.
+    size_t capacity() const noexcept
+    {
+        return tableSize;
+    }
+
+    // Removes all entries without releasing the table allocation.
+    void clear() noexcept
+    {
+        for (size_t i = 0; i < tableSize; i++) {
+            if (table[i].state == OCCUPIED) {
+                destroyEntry(i);
+            }
+        }
+        count = 0;
+    }
+
+public:
+    typedef struct key_value_s {
+        K& key;
+        V& value;
+    } key_value_t;
+
+    // Exposes a read-only key-value view when iterating a const map.
+    typedef struct const_key_value_s {
+        const K& key;
+        const V& value;
+    } const_key_value_t;
+
+public:
+    class iterator
+    {
+    public:
+        // Creates an iterator over the allocated table range.
+        iterator(Entry_t* p, Entry_t* e) noexcept : ptr(p), end(e)
+        {
+            while (ptr != end && ptr->state != OCCUPIED) {
+                ptr += 1;
+            }
+        }
+
+        // Advances to the next occupied slot.
+        iterator& operator++() noexcept
+        {
+            if (ptr != end) {
+                ptr += 1;
+                while (ptr != end && ptr->state != OCCUPIED) {
+                    ptr += 1;
+                }
+            }
+            return *this;
+        }
+
+        // Compares iterator positions.
+        bool operator!=(const iterator& other) const noexcept
+        {
+            return ptr != other.ptr;
+        }
+
+        // Returns references to the current key and value.
+        key_value_t operator*() noexcept
+        {
+            return {ptr->key, ptr->value};
+        }
+
+    private:
+        Entry_t* ptr;
+        Entry_t* end;
+    };
+
+    class const_iterator
+    {
+    public:
+        // Creates a const iterator over the allocated table range.
+        const_iterator(const Entry_t* p, const Entry_t* e) noexcept : ptr(p), end(e)
+        {
+            while (ptr != end && ptr->state != OCCUPIED) {
+                ptr += 1;
+            }
+        }
+
+        // Advances to the next occupied slot.
+        const_iterator& operator++() noexcept
+        {
+            if (ptr != end) {
+                ptr += 1;
+                while (ptr != end && ptr->state != OCCUPIED) {
+                    ptr += 1;
+                }
+            }
+            return *this;
+        }
+
+        // Compares iterator positions.
+        bool operator!=(const const_iterator& other) const noexcept
+        {
+            return ptr != other.ptr;
+        }
+
+        // Returns const references to the current key and value.
+        const_key_value_t operator*() const noexcept
+        {
+            return {ptr->key, ptr->value};
+        }
+
+    private:
+        const Entry_t* ptr;
+        const Entry_t* end;
+    };
+
+public:
+    // Iteration follows internal table/probe order, not key order.
+    iterator begin() noexcept
+    {
+        return iterator(table, table ? (table + tableSize) : nullptr);
+    }
+
+    // Returns an iterator one past the last table slot.
+    iterator end() noexcept
+    {
+        Entry_t *e = table ? (table + tableSize) : nullptr;
+
+        return iterator(e, e);
+    }
+
+    // Returns a const iterator to the first occupied slot.
+    const_iterator begin() const noexcept
+    {
+        return const_iterator(table, table ? (table + tableSize) : nullptr);
+    }
+
+    // Returns a const iterator one past the last table slot.
+    const_iterator end() const noexcept
+    {
+        const Entry_t *e = table ? (table + tableSize) : nullptr;
+
+        return const_iterator(e, e);
+    }
+
+private:
+    static constexpr size_t MIN_TABLE_SIZE = 8;
+
+    // Reports whether entries keys stay within the load limit of a table with slots slots.
+    bool fits(size_t entries, size_t slots) const noexcept
+    {
+        return entries <= slots / 100 * maxLoadPercent + (slots % 100) * maxLoadPercent / 100;
+    }
+
+    template <class Q>
+    V* findImpl(const Q& key) noexcept
+    {
+        if (count == 0) {
+            return nullptr;
+        }
+
+        size_t idx = findSlot(key);
+        return (table[idx].state == OCCUPIED) ? &table[idx].value : nullptr;
+    }
+
+    template <class Q>
+    bool eraseImpl(const Q& key) noexcept
+    {
+        if (count == 0) {
+            return false;
+        }
+
+        size_t hole = findSlot(key);
+        if (table[hole].state != OCCUPIED) {
+            return false;
+        }
+        destroyEntry(hole);
+        count -= 1;
+
+        // Backward-shift deletion: pull forward every later entry of the run whose home
+        // slot is not located cyclically in (hole, idx].
+        const size_t mask = tableSize - 1;
+        size_t idx = hole;
+        for (;;) {
+            idx = (idx + 1) & mask;
+            if (table[idx].state != OCCUPIED) {
+                break;
+            }
+
+            size_t home = hasher(table[idx].key) & mask;
+            if (((idx - home) & mask) >= ((idx - hole) & mask)) {
+                moveEntry(hole, idx);
+                hole = idx;
+            }
+        }
+        return true;
+    }
+
+    // Returns the slot holding key, or the empty slot ending its probe run. The table must not be full.
+    template <class Q>
+    size_t findSlot(const Q& key) const noexcept
+    {
+        const size_t mask = tableSize - 1;
+        size_t idx = hasher(key) & mask;
+
+        while (table[idx].state == OCCUPIED && !keyEqual(table[idx].key, key)) {
+            idx = (idx + 1) & mask;
+        }
+        return idx;
+    }
+
+    template <class KArg, class VArg>
+    V* insertOrAssign(KArg&& key, VArg&& value, bool* inserted) noexcept
+    {
+        size_t idx;
+
+        if (inserted) {
+            *inserted = false;
+        }
+
+        if (tableSize > 0) {
+            idx = findSlot(key);
+            if (table[idx].state == OCCUPIED) {
+                table[idx].value = std::forward<VArg>(value); // Update existing
+                return &table[idx].value;
+            }
+        }
+        if (!fits(count + 1, tableSize)) {
+            if (isInTable(&key) || isInTable(&value)) {
+                // The arguments reference entries that move when the table grows.
+                K keyCopy(std::forward<KArg>(key));
+                V valueCopy(std::forward<VArg>(value));
+
+                if (!reserve(count + 1)) {
+                    return nullptr;
+                }
+                return insertNew(std::move(keyCopy), std::move(valueCopy), inserted);
+            }
+            if (!reserve(count + 1)) {
+                return nullptr;
+            }
+        }
+        return insertNew(std::forward<KArg>(key), std::forward<VArg>(value), inserted);
+    }
+
+    bool isInTable(const void *p) const noexcept
+    {
+        return table && p >= static_cast<const void*>(table) && p < static_cast<const void*>(table + tableSize);
+    }
+
+    template <class KArg, class VArg>
+    V* insertNew(KArg&& key, VArg&& value, bool* inserted) noexcept
+    {
+        size_t idx = findSlot(key);
+
+        ::new (static_cast<void*>(&table[idx].key)) K(std::forward<KArg>(key));
+        ::new (static_cast<void*>(&table[idx].value)) V(std::forward<VArg>(value));
+        table[idx].state = OCCUPIED;
+        count += 1;
+        if (inserted) {
+            *inserted = true;
+        }
+        return &table[idx].value;
+    }
+
+    bool rehash(size_t newSize) noexcept
+    {
+        Entry_t *oldTable = table;
+        size_t oldSize = tableSize;
+
+        table = (Entry_t *)alloc->allocate(newSize * sizeof(Entry_t));
+        if (!table) {
+            table = oldTable;
+            return false;
+        }
+        tableSize = newSize;
+        for (size_t i = 0; i < newSize; i++) {
+            table[i].state = EMPTY;
+        }
+
+        for (size_t i = 0; i < oldSize; i++) {
+            if (oldTable[i].state == OCCUPIED) {
+                size_t idx = findSlot(oldTable[i].key);
+
+                ::new (static_cast<void*>(&table[idx].key)) K(std::move(oldTable[i].key));
+                ::new (static_cast<void*>(&table[idx].value)) V(std::move(oldTable[i].value));
+                table[idx].state = OCCUPIED;
+                oldTable[i].key.~K();
+                oldTable[i].value.~V();
+            }
+        }
+        if (oldTable) {
+            alloc->deallocate(oldTable);
+        }
+        return true;
+    }
+
+    void moveEntry(size_t to, size_t from) noexcept
+    {
+        ::new (static_cast<void*>(&table[to].key)) K(std::move(table[from].key));
+        ::new (static_cast<void*>(&table[to].value)) V(std::move(table[from].value));
+        table[to].state = OCCUPIED;
+        destroyEntry(from);
+    }
+
+    void destroyEntry(size_t idx) noexcept
+    {
+        table[idx].key.~K();
+        table[idx].value.~V();
+        table[idx].state = EMPTY;
+    }
+
+    void release() noexcept
+    {
+        if (table) {
+            clear();
+            alloc->deallocate(table);
+            table = nullptr;
+        }
+        tableSize = 0;
+        count = 0;
+    }
+
+private:
+    HashFn hasher;
+    KeyEqual keyEqual;
+    IAllocator *alloc{nullptr};
+    Entry_t *table{nullptr};
+    size_t tableSize{0};
+    size_t count{0};
+    uint8_t maxLoadPercent{75};
 };
 
 } // namespace lightstd
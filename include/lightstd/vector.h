@@ -16,49 +16,176 @@
 
 namespace lightstd {
 
-// NOTE: lightstd::vector does NOT throw exceptions on purpose.
+// Growth policies select the capacity used when a vector runs out of room. Each one exposes
+// next_capacity(current, minNeeded, maxSize), which must return a value >= minNeeded.
+
+// Doubles the capacity, starting at MinCapacity elements. This is the default.
+template <size_t MinCapacity = 16>
+struct growth_policy_double
+{
+    static size_t next_capacity(size_t current, size_t minNeeded, size_t maxSize) noexcept
+    {
+        size_t c = (current < MinCapacity) ? MinCapacity : current;
+
+        while (c < minNeeded) {
+            if (c > maxSize / 2) {
+                return minNeeded;
+            }
+            c *= 2;
+        }
+        return c;
+    }
+};
+
+// Grows the capacity by 50%, starting at MinCapacity elements. Trades a few more reallocations for less slack.
+template <size_t MinCapacity = 16>
+struct growth_policy_one_and_half
+{
+    static size_t next_capacity(size_t current, size_t minNeeded, size_t maxSize) noexcept
+    {
+        size_t c = (current < MinCapacity) ? MinCapacity : current;
+
+        while (c < minNeeded) {
+            if (c > maxSize / 3 * 2) {
+                return minNeeded;
+            }
+            c += (c > 1) ? c / 2 : 1;
+        }
+        return c;
+    }
+};
+
+// Allocates exactly the requested capacity. Use when the final size is known up front.
+struct growth_policy_exact
+{
+    static size_t next_capacity(size_t, size_t minNeeded, size_t) noexcept
+    {
+        return minNeeded;
+    }
+};
+
+// -----------------------------------------------------------------------------
+
+namespace detail {
+
+// Holds the inline element storage used by small vectors. Empty when no inline capacity is requested.
+template <class T, size_t N>
+struct vector_inline_buffer
+{
+    T* inline_data() noexcept
+    {
+        return reinterpret_cast<T*>(buf);
+    }
+
+    alignas(T) unsigned char buf[N * sizeof(T)];
+};
+
+template <class T>
+struct vector_inline_buffer<T, 0>
+{
+    T* inline_data() noexcept
+    {
+        return nullptr;
+    }
+};
+
+// Move-constructs count elements from src into the uninitialized storage at dest.
+template <class T>
+void vector_move_construct(T* dest, T* src, size_t count) noexcept
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        // For trivial types (int, float, pointers, POD structs) a single memcpy
+        // is correct and significantly faster than element-wise move construction.
+        if (count > 0) {
+            memcpy(static_cast<void*>(dest), src, count * sizeof(T));
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            ::new (static_cast<void*>(dest + i)) T(std::move(src[i]));
+        }
+    }
+}
+
+// Copy-constructs count elements from src into the uninitialized storage at dest.
 template <class T>
-class vector final
+void vector_copy_construct(T* dest, const T* src, size_t count) noexcept
+{
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        if (count > 0) {
+            memcpy(static_cast<void*>(dest), src, count * sizeof(T));
+        }
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            ::new (static_cast<void*>(dest + i)) T(src[i]);
+        }
+    }
+}
+
+// Rotates the elements in [first, last) so the one at middle becomes the first one.
+template <class T>
+void vector_rotate(T* base, size_t first, size_t middle, size_t last) noexcept
+{
+    size_t next = middle;
+
+    if (first == middle || middle == last) {
+        return;
+    }
+    while (first != next) {
+        T tmp(std::move(base[first]));
+
+        base[first] = std::move(base[next]);
+        base[next] = std::move(tmp);
+        first++;
+        next++;
+        if (next == last) {
+            next = middle;
+        }
+        else if (first == middle) {
+            middle = next;
+        }
+    }
+}
+
+// Shared implementation of lightstd::vector and lightstd::small_vector. The first InlineCapacity
+// elements live inside the object and the storage spills to the allocator beyond that.
+template <class T, size_t InlineCapacity, class GrowthPolicy>
+class basic_vector : private vector_inline_buffer<T, InlineCapacity>
 {
 public:
     using iterator        = T*;
     using const_iterator  = const T*;
 
     // Creates an empty vector using the provided allocator or the default one.
-    vector(IAllocator *_alloc = nullptr) noexcept
+    basic_vector(IAllocator *_alloc = nullptr) noexcept
     {
         alloc = _alloc ? _alloc : IAllocator::getDefault();
+        ptr = this->inline_data();
+        cap = InlineCapacity;
     }
 
-    vector(const vector&) noexcept = delete;
+    basic_vector(const basic_vector&) noexcept = delete;
     // Transfers ownership of the vector storage.
-    vector(vector&& other) noexcept : ptr(other.ptr), len(other.len), cap(other.cap), alloc(other.alloc)
+    basic_vector(basic_vector&& other) noexcept : alloc(other.alloc)
     {
-        other.ptr = nullptr;
-        other.len = 0;
-        other.cap  = 0;
+        ptr = this->inline_data();
+        cap = InlineCapacity;
+        take_from(other);
     }
 
-    vector& operator=(const vector&) noexcept = delete;
-    vector& operator=(vector&& other) noexcept
+    basic_vector& operator=(const basic_vector&) noexcept = delete;
+    basic_vector& operator=(basic_vector&& other) noexcept
     {
         if (this != &other) {
             destroy_and_deallocate();
 
-            ptr = other.ptr;
-            len = other.len;
-            cap  = other.cap;
             alloc = other.alloc;
-
-            other.ptr = nullptr;
-            other.len = 0;
-            other.cap  = 0;
+            take_from(other);
         }
         return *this;
     }
 
     // Releases the owned storage and destroys live elements.
-    ~vector() noexcept
+    ~basic_vector() noexcept
     {
         destroy_and_deallocate();
     }
@@ -184,7 +311,6 @@ public:
         if constexpr (!std::is_trivially_destructible_v<T>) {
             ptr[len].~T();
         }
-        ptr[len].~T();
     }
 
     // Ensures capacity for at least the requested number of elements.
@@ -284,6 +410,22 @@ public:
         return true;
     }
 
+    // Resizes the vector leaving new elements uninitialized, for buffers that are about to be overwritten.
+    [[nodiscard]] bool resize_uninitialized(size_t newLen) noexcept
+    {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "resize_uninitialized requires T to be a trivial type.");
+
+        if (newLen > cap) {
+            if (!reallocate(growth_capacity(newLen), false)) {
+                return false;
+            }
+        }
+
+        len = newLen;
+        return true;
+    }
+
     // Appends a copy of the provided element.
     [[nodiscard]] bool push_back(const T& v) noexcept
     {
@@ -352,6 +494,153 @@ public:
         len = newLen;
     }
 
+    // Appends a copy of count elements taken from a contiguous source range.
+    [[nodiscard]] bool append(const T* src, size_t count) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "append requires T to be nothrow copy constructible.");
+
+        if (count == 0) {
+            return true;
+        }
+        assert(src);
+
+        // The source may live inside our own buffer; remember its index so it
+        // can be located again if the storage gets reallocated.
+        const bool aliases = (ptr && src >= ptr && src < ptr + len);
+        const size_t aliasIdx = aliases ? static_cast<size_t>(src - ptr) : 0;
+
+        if (!ensure_capacity_for(count)) {
+            return false;
+        }
+        if (aliases) {
+            src = ptr + aliasIdx;
+        }
+
+        vector_copy_construct(ptr + len, src, count);
+
+        len += count;
+        return true;
+    }
+
+    // Inserts a copy of the range [first, last) before pos.
+    [[nodiscard]] bool insert(const_iterator pos, const T* first, const T* last) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "insert requires T to be nothrow copy constructible.");
+
+        assert(pos >= cbegin() && pos <= cend());
+        assert(first <= last);
+
+        const size_t idx = static_cast<size_t>(pos - cbegin());
+        const size_t count = static_cast<size_t>(last - first);
+
+        if (count == 0) {
+            return true;
+        }
+        if (idx == len) {
+            return append(first, count);
+        }
+
+        const bool aliases = (ptr && first >= ptr && first < ptr + len);
+        const size_t aliasIdx = aliases ? static_cast<size_t>(first - ptr) : 0;
+
+        if (!ensure_capacity_for(count)) {
+            return false;
+        }
+        if (aliases) {
+            first = ptr + aliasIdx;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            // Open the gap with a single memmove and copy the new elements in.
+            memmove(ptr + idx + count, ptr + idx, (len - idx) * sizeof(T));
+            if (!aliases) {
+                memcpy(ptr + idx, first, count * sizeof(T));
+            }
+            else {
+                // Source elements located before the gap did not move while
+                // the ones at or after it were shifted by count positions.
+                size_t before = (aliasIdx < idx) ? idx - aliasIdx : 0;
+
+                if (before > count) {
+                    before = count;
+                }
+                if (before > 0) {
+                    memcpy(ptr + idx, first, before * sizeof(T));
+                }
+                if (before < count) {
+                    memcpy(ptr + idx + before, first + before + count, (count - before) * sizeof(T));
+                }
+            }
+        }
+        else {
+            // Construct the new elements at the end, then rotate them into place.
+            vector_copy_construct(ptr + len, first, count);
+            vector_rotate(ptr, idx, len, len + count);
+        }
+
+        len += count;
+        return true;
+    }
+
+    // Removes the elements in [first, last) and returns an iterator to the element that followed them.
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        assert(first >= cbegin() && first <= last && last <= cend());
+
+        const size_t from = static_cast<size_t>(first - cbegin());
+        const size_t to = static_cast<size_t>(last - cbegin());
+
+        if (from == to) {
+            return ptr + from;
+        }
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            memmove(ptr + from, ptr + to, (len - to) * sizeof(T));
+        }
+        else {
+            for (size_t i = to; i < len; ++i) {
+                ptr[from + (i - to)] = std::move(ptr[i]);
+            }
+            destroy_range(len - (to - from), len);
+        }
+
+        len -= to - from;
+        return ptr + from;
+    }
+
+    // Replaces the contents with count copies of the provided value.
+    [[nodiscard]] bool assign(size_t count, const T& value) noexcept
+    {
+        static_assert(std::is_nothrow_copy_constructible_v<T>, "assign requires T to be nothrow copy constructible.");
+
+        // Keep a private copy if the value lives inside the buffer being replaced.
+        if (ptr && &value >= ptr && &value < ptr + len) {
+            T valueCopy(value);
+
+            return assign(count, valueCopy);
+        }
+
+        // Grow before clearing so a failed allocation leaves the vector unchanged.
+        if (count > cap) {
+            if (!reallocate(count, false)) {
+                return false;
+            }
+        }
+        clear();
+
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) == 1) {
+            memset(static_cast<void*>(ptr), *reinterpret_cast<const unsigned char*>(&value), count);
+        }
+        else {
+            for (size_t i = 0; i < count; ++i) {
+                ::new (static_cast<void*>(ptr + i)) T(value);
+            }
+        }
+
+        len = count;
+        return true;
+    }
+
 private:
     static constexpr size_t max_array_size() noexcept
     {
@@ -360,15 +649,7 @@ private:
 
     [[nodiscard]] size_t growth_capacity(size_t minNeeded) const noexcept
     {
-        size_t c = (cap < 16) ? 16 : cap;
-
-        while (c < minNeeded) {
-            if (c > max_array_size() / 2) {
-                return minNeeded;
-            }
-            c *= 2;
-        }
-        return c;
+        return GrowthPolicy::next_capacity(cap, minNeeded, max_array_size());
     }
 
     [[nodiscard]] bool ensure_capacity_for_one_more() noexcept
@@ -382,12 +663,27 @@ private:
         return reallocate(growth_capacity(len + 1), false);
     }
 
+    [[nodiscard]] bool ensure_capacity_for(size_t count) noexcept
+    {
+        if (count <= cap - len) {
+            return true;
+        }
+        if (count > max_array_size() - len) {
+            return false;
+        }
+        return reallocate(growth_capacity(len + count), false);
+    }
+
     [[nodiscard]] bool reallocate(size_t newCapacity, bool force) noexcept
     {
         T* newPtr;
 
         static_assert(std::is_nothrow_move_constructible_v<T>, "vector requires T to be nothrow move constructible for reallocation.");
 
+        // Never go below the inline capacity, the inline buffer is always available.
+        if (newCapacity < InlineCapacity) {
+            newCapacity = InlineCapacity;
+        }
         if (!force && newCapacity <= cap) {
             return true;
         }
@@ -398,42 +694,28 @@ private:
             return false;
         }
 
-        // Nothing to (re)allocate — just free existing storage.
-        if (newCapacity == 0) {
-            if (ptr) {
-                alloc->deallocate(ptr);
-                ptr = nullptr;
-                cap = 0;
-            }
-            return true;
+        if (newCapacity == InlineCapacity) {
+            // Going back to the inline buffer (or releasing everything if there is none).
+            newPtr = this->inline_data();
         }
-
-        // Allocate raw storage (nothrow)
-        newPtr = static_cast<T*>(alloc->allocate(newCapacity * sizeof(T)));
-        if (!newPtr) {
-            return false;
+        else {
+            // Allocate raw storage (nothrow)
+            newPtr = static_cast<T*>(alloc->allocate(newCapacity * sizeof(T)));
+            if (!newPtr) {
+                return false;
+            }
         }
 
         // Only move elements that will survive the resize. Elements beyond
         // newCapacity are simply left in the old buffer and destroyed there.
         size_t newLen = (len < newCapacity) ? len : newCapacity;
 
-        if constexpr (std::is_trivially_copyable_v<T>) {
-            // For trivial types (int, float, pointers, POD structs) a single memcpy
-            // is correct and significantly faster than element-wise move construction.
-            if (newLen > 0) {
-                memcpy(newPtr, ptr, newLen * sizeof(T));
-            }
-        } else {
-            for (size_t i = 0; i < newLen; ++i) {
-                ::new (static_cast<void*>(newPtr + i)) T(std::move(ptr[i]));
-            }
-        }
+        vector_move_construct(newPtr, ptr, newLen);
 
         // Destroy old elements + free old storage
         destroy_range(0, len);
 
-        if (ptr) {
+        if (is_heap_allocated()) {
             alloc->deallocate(ptr);
         }
 
@@ -443,6 +725,31 @@ private:
         return true;
     }
 
+    // Reports whether the current storage was obtained from the allocator.
+    bool is_heap_allocated() noexcept
+    {
+        return ptr && ptr != this->inline_data();
+    }
+
+    // Steals the storage of other, moving the elements one by one if they live in its inline buffer.
+    void take_from(basic_vector& other) noexcept
+    {
+        if (other.is_heap_allocated()) {
+            ptr = other.ptr;
+            len = other.len;
+            cap = other.cap;
+        }
+        else {
+            vector_move_construct(ptr, other.ptr, other.len);
+            other.destroy_range(0, other.len);
+            len = other.len;
+        }
+
+        other.ptr = other.inline_data();
+        other.len = 0;
+        other.cap = InlineCapacity;
+    }
+
     void destroy_range(size_t from, size_t to) noexcept
     {
         assert(ptr || from == to);
@@ -460,13 +767,13 @@ private:
 
     void destroy_and_deallocate() noexcept
     {
-        if (ptr) {
-            destroy_range(0, len);
+        destroy_range(0, len);
+        if (is_heap_allocated()) {
             alloc->deallocate(ptr);
-            ptr = nullptr;
-            len = 0;
-            cap  = 0;
         }
+        ptr = this->inline_data();
+        len = 0;
+        cap  = InlineCapacity;
     }
 
 private:
@@ -476,4 +783,15 @@ private:
     IAllocator *alloc{nullptr};
 };
 
+} // namespace detail
+
+// Contiguous, growable array that allocates its storage through an IAllocator.
+// NOTE: lightstd::vector does NOT throw exceptions on purpose.
+template <class T, class GrowthPolicy = growth_policy_double<>>
+class vector final : public detail::basic_vector<T, 0, GrowthPolicy>
+{
+public:
+    using detail::basic_vector<T, 0, GrowthPolicy>::basic_vector;
+};
+
 } // namespace lightstd
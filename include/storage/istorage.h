@@ -4,6 +4,7 @@
     #error C++ compiler required.
 #endif // !__cplusplus
 
+#include "../lightstd/span.h"
 #include "../lightstd/string.h"
 #include "../lightstd/vector.h"
 #include <esp_err.h>
@@ -23,6 +24,11 @@ public:
     virtual esp_err_t readBlob(const char *key, lightstd::vector<uint8_t> &blob) = 0;
     // Writes a blob value for the given key.
     virtual esp_err_t writeBlob(const char *key, const void *value, size_t valueLen) = 0;
+    // Writes a blob value taken from a byte range.
+    esp_err_t writeBlob(const char *key, lightstd::span<const uint8_t> value)
+    {
+        return writeBlob(key, value.data(), value.size());
+    }
 
     // Reads a 32-bit integer value into the provided output pointer.
     virtual esp_err_t readInt(const char *key, int32_t *pValue) = 0;
@@ -39,6 +39,7 @@ public:
     esp_err_t readBlob(const char *key, lightstd::vector<uint8_t> &blob) noexcept;
     // Writes a blob value to NVS.
     esp_err_t writeBlob(const char *key, const void *value, size_t valueLen) noexcept;
+    using IStorage::writeBlob;
 
     // Reads a 32-bit integer value from NVS.
     esp_err_t readInt(const char *key, int32_t *pValue) noexcept;
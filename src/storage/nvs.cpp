@@ -172,8 +172,8 @@ esp_err_t NVSStorage::readBlob(const char *key, lightstd::vector<uint8_t> &blob)
         goto exit;
     }
 
-    // Allocate output
-    if (!blob.resize(requiredSize)) {
+    // Allocate output (no need to zero it, nvs_get_blob overwrites the whole range)
+    if (!blob.resize_uninitialized(requiredSize)) {
         err = ESP_ERR_NO_MEM;
         goto exit;
     }
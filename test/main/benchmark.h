@@ -0,0 +1,30 @@
+#pragma once
+
+#include <esp_timer.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// -----------------------------------------------------------------------------
+
+// Prevents the compiler from optimizing away a value produced by a benchmark.
+template <typename T>
+static inline void benchmarkKeep(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Runs the callable the requested number of times and prints the average cost per iteration.
+template <typename Fn>
+static int64_t benchmarkRun(const char *name, uint32_t iterations, Fn&& fn)
+{
+    int64_t startUs = esp_timer_get_time();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        fn(i);
+    }
+
+    int64_t elapsedUs = esp_timer_get_time() - startUs;
+    printf("[bench] %-48s %8lu iters %10lld us %10.3f us/iter\n", name, (unsigned long)iterations, (long long)elapsedUs,
+           (double)elapsedUs / (double)(iterations ? iterations : 1));
+    return elapsedUs;
+}
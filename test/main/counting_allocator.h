@@ -0,0 +1,26 @@
+#pragma once
+
+#include "lightstd/allocator.h"
+
+// -----------------------------------------------------------------------------
+
+// Forwards to the default allocator while counting the calls made through it.
+class CountingAllocator : public lightstd::IAllocator
+{
+public:
+    void* allocate(const size_t bytes) noexcept
+    {
+        allocations += 1;
+        return lightstd::IAllocator::getDefault()->allocate(bytes);
+    }
+
+    void deallocate(void* ptr) noexcept
+    {
+        deallocations += 1;
+        lightstd::IAllocator::getDefault()->deallocate(ptr);
+    }
+
+public:
+    size_t allocations{0};
+    size_t deallocations{0};
+};
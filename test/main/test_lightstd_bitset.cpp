@@ -0,0 +1,95 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <unity.h>
+#include "lightstd/bitset.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd bitset set test and scan", "lightstd bitset")
+{
+    bitset<70> bits;
+
+    TEST_ASSERT_EQUAL_UINT32(70, bits.size());
+    TEST_ASSERT_EQUAL_UINT32(3, bits.word_count());
+    TEST_ASSERT_TRUE(bits.none());
+    TEST_ASSERT_EQUAL_UINT32(bits.npos, bits.find_first());
+
+    bits.set(0);
+    bits.set(31);
+    bits.set(32);
+    bits.set(69);
+    TEST_ASSERT_TRUE(bits.test(31));
+    TEST_ASSERT_FALSE(bits[30]);
+    TEST_ASSERT_EQUAL_UINT32(4, bits.count());
+
+    // Walk the set bits across word boundaries.
+    static const size_t kExpected[] = {0, 31, 32, 69};
+    size_t idx = 0;
+    for (size_t pos = bits.find_first(); pos != bits.npos; pos = bits.find_next(pos)) {
+        TEST_ASSERT_EQUAL_UINT32(kExpected[idx++], pos);
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, idx);
+
+    bits.reset(0);
+    bits.flip(31);
+    TEST_ASSERT_EQUAL_UINT32(32, bits.find_first());
+    TEST_ASSERT_EQUAL_UINT32(0, bits.find_first_unset());
+    TEST_ASSERT_EQUAL_UINT32(33, bits.find_next_unset(32));
+
+    // The unused bits of the last word never show up.
+    bits.set_all();
+    TEST_ASSERT_TRUE(bits.all());
+    TEST_ASSERT_EQUAL_UINT32(70, bits.count());
+    TEST_ASSERT_EQUAL_UINT32(bits.npos, bits.find_first_unset());
+    TEST_ASSERT_EQUAL_UINT32(bits.npos, bits.find_next(69));
+
+    bitset<70> other;
+    other.set(5);
+    other.set(64);
+    bits &= other;
+    TEST_ASSERT_TRUE(bits == other);
+    bits ^= other;
+    TEST_ASSERT_TRUE(bits.none());
+    bits |= other;
+    TEST_ASSERT_EQUAL_UINT32(2, bits.count());
+    bits.reset_all();
+    TEST_ASSERT_TRUE(bits != other);
+}
+
+TEST_CASE("lightstd dynamic_bitset resize", "lightstd bitset")
+{
+    CountingAllocator alloc;
+    {
+        dynamic_bitset bits(&alloc);
+
+        TEST_ASSERT_EQUAL_UINT32(0, bits.size());
+        TEST_ASSERT_EQUAL_UINT32(bits.npos, bits.find_first_unset());
+
+        TEST_ASSERT_TRUE(bits.resize(40));
+        TEST_ASSERT_TRUE(bits.none());
+        bits.set_all();
+        TEST_ASSERT_EQUAL_UINT32(40, bits.count());
+
+        // Growing keeps the old bits and clears the new ones, including the old tail of the last word.
+        TEST_ASSERT_TRUE(bits.resize(100));
+        TEST_ASSERT_EQUAL_UINT32(40, bits.count());
+        TEST_ASSERT_EQUAL_UINT32(40, bits.find_first_unset());
+
+        // Shrinking drops the bits past the new size.
+        TEST_ASSERT_TRUE(bits.resize(10));
+        TEST_ASSERT_EQUAL_UINT32(10, bits.count());
+        TEST_ASSERT_TRUE(bits.resize(20));
+        TEST_ASSERT_EQUAL_UINT32(10, bits.count());
+
+        dynamic_bitset moved(std::move(bits));
+        TEST_ASSERT_EQUAL_UINT32(0, bits.size());
+        TEST_ASSERT_EQUAL_UINT32(20, moved.size());
+        TEST_ASSERT_EQUAL_UINT32(9, moved.find_next(8));
+        TEST_ASSERT_EQUAL_UINT32(moved.npos, moved.find_next(9));
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
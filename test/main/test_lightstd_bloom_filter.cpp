@@ -0,0 +1,103 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <unity.h>
+#include "lightstd/bloom_filter.h"
+#include "lightstd/unordered_map.h"
+#include "benchmark.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd bloom_filter sizing and membership", "lightstd bloom_filter")
+{
+    CountingAllocator alloc;
+    {
+        bloom_filter filter(&alloc);
+
+        TEST_ASSERT_FALSE(filter.might_contain(1u));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, filter.init(0));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, filter.init(100, 0.0f));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, filter.init(100, 1.0f));
+
+        // 1000 keys at 1% take about 9.6 bits each and 7 probes.
+        TEST_ASSERT_EQUAL(ESP_OK, filter.init(1000, 0.01f));
+        TEST_ASSERT_EQUAL_UINT32(7, filter.hash_count());
+        TEST_ASSERT_EQUAL_UINT32(9600, filter.bit_count());
+        TEST_ASSERT_EQUAL_UINT32(1200, filter.byte_size());
+
+        for (uint32_t id = 0; id < 1000; id++) {
+            filter.add(id * 7919u);
+        }
+        // No false negatives.
+        for (uint32_t id = 0; id < 1000; id++) {
+            TEST_ASSERT_TRUE(filter.might_contain(id * 7919u));
+        }
+
+        // The measured false positive rate stays near the requested one.
+        uint32_t falsePositives = 0;
+        for (uint32_t id = 0; id < 20000; id++) {
+            if (filter.might_contain(id * 7919u + 1)) {
+                falsePositives++;
+            }
+        }
+        TEST_ASSERT_LESS_THAN_UINT32(400, falsePositives);
+        TEST_ASSERT_TRUE(filter.estimated_false_positive_rate() < 0.02f);
+
+        filter.clear();
+        TEST_ASSERT_FALSE(filter.might_contain(0u));
+        filter.deinit();
+        TEST_ASSERT_EQUAL_UINT32(0, filter.bit_count());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd bloom_filter string keys and test_and_add", "lightstd bloom_filter")
+{
+    bloom_filter filter;
+    const uint8_t raw[] = {0xDE, 0xAD, 0xBE, 0xEF};
+
+    TEST_ASSERT_EQUAL(ESP_OK, filter.init(64, 0.001f));
+    TEST_ASSERT_FALSE(filter.test_and_add("home/livingroom/temp"));
+    TEST_ASSERT_TRUE(filter.test_and_add("home/livingroom/temp"));
+    TEST_ASSERT_TRUE(filter.might_contain(string_view("home/livingroom/temp")));
+    TEST_ASSERT_FALSE(filter.might_contain("home/livingroom"));
+
+    // Keys hash by bytes, so a view and a raw range with the same bytes match.
+    filter.add(raw, sizeof(raw));
+    TEST_ASSERT_TRUE(filter.might_contain(string_view((const char *)raw, sizeof(raw))));
+    TEST_ASSERT_FALSE(filter.test_and_add(uint64_t(42)));
+    TEST_ASSERT_TRUE(filter.might_contain(uint64_t(42)));
+}
+
+TEST_CASE("lightstd bloom_filter dedup benchmark", "lightstd bloom_filter benchmark")
+{
+    constexpr size_t kWindow = 1024;
+    constexpr uint32_t kLookups = 20000;
+    bloom_filter filter;
+    static_hash_map<uint32_t, uint8_t> seen;
+
+    TEST_ASSERT_EQUAL(ESP_OK, filter.init(kWindow, 0.01f));
+    TEST_ASSERT_EQUAL(ESP_OK, seen.init(kWindow * 4 / 3 + 1));
+    for (uint32_t id = 0; id < kWindow; id++) {
+        filter.add(id * 2654435761u);
+        TEST_ASSERT_NOT_NULL(seen.insert(id * 2654435761u, 1));
+    }
+    printf("[bench] %lu message IDs: bloom_filter %lu bytes, static_hash_map %lu bytes\n", (unsigned long)kWindow,
+           (unsigned long)filter.byte_size(),
+           (unsigned long)((kWindow * 4 / 3 + 1) * static_hash_map<uint32_t, uint8_t>::bytes_per_slot));
+
+    benchmarkRun("bloom_filter seen ID", kLookups, [&](uint32_t i) {
+        benchmarkKeep(filter.might_contain((i % kWindow) * 2654435761u));
+    });
+    benchmarkRun("static_hash_map seen ID", kLookups, [&](uint32_t i) {
+        benchmarkKeep(seen.find((i % kWindow) * 2654435761u));
+    });
+    benchmarkRun("bloom_filter new ID", kLookups, [&](uint32_t i) {
+        benchmarkKeep(filter.might_contain(i * 2654435761u + 1));
+    });
+    benchmarkRun("static_hash_map new ID", kLookups, [&](uint32_t i) {
+        benchmarkKeep(seen.find(i * 2654435761u + 1));
+    });
+}
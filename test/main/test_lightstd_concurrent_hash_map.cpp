@@ -0,0 +1,237 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "lightstd/concurrent_hash_map.h"
+#include "mutex.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+static constexpr UBaseType_t kTaskPriority = tskIDLE_PRIORITY + 1;
+static constexpr uint32_t kTaskStackSize = 4096;
+static constexpr TickType_t kTestTimeout = pdMS_TO_TICKS(10000);
+static constexpr uint32_t kKeyCount = 512;
+
+// -----------------------------------------------------------------------------
+
+namespace {
+
+// static_hash_map behind a single RWMutex, the pattern concurrent_hash_map replaces.
+class LockedMap
+{
+public:
+    esp_err_t init(size_t tableSize)
+    {
+        return map.init(tableSize);
+    }
+
+    bool insert(uint32_t key, uint32_t value)
+    {
+        AutoRWMutex lock(rwMtx, false);
+
+        return map.insert(key, value) != nullptr;
+    }
+
+    bool find(uint32_t key, uint32_t& value)
+    {
+        AutoRWMutex lock(rwMtx, true);
+        uint32_t *found = map.find(key);
+
+        if (!found) {
+            return false;
+        }
+        value = *found;
+        return true;
+    }
+
+private:
+    RWMutex rwMtx;
+    static_hash_map<uint32_t, uint32_t> map;
+};
+
+template <class Map>
+struct WorkerArgs
+{
+    Map *map;
+    TaskHandle_t mainTask;
+    uint32_t seed;
+    uint32_t operations;
+    uint32_t firstKey;
+    uint32_t failures;
+};
+
+// Runs a 90% lookup / 10% update mix over the shared key range.
+template <class Map>
+static void mixedWorkerTask(void *arg)
+{
+    WorkerArgs<Map> *args = static_cast<WorkerArgs<Map> *>(arg);
+    uint32_t seed = args->seed;
+
+    for (uint32_t i = 0; i < args->operations; i++) {
+        uint32_t key, value;
+
+        seed = seed * 1664525u + 1013904223u;
+        key = (seed >> 8) % kKeyCount;
+        if ((seed >> 4) % 10 == 0) {
+            if (!args->map->insert(key, key + i)) {
+                args->failures++;
+            }
+        }
+        else if (!args->map->find(key, value)) {
+            args->failures++;
+        }
+    }
+
+    xTaskNotifyGive(args->mainTask);
+    vTaskDelete(nullptr);
+}
+
+// Inserts its own key range, then checks every key it wrote.
+static void insertWorkerTask(void *arg)
+{
+    WorkerArgs<concurrent_hash_map<uint32_t, uint32_t>> *args = static_cast<WorkerArgs<concurrent_hash_map<uint32_t, uint32_t>> *>(arg);
+
+    for (uint32_t i = 0; i < args->operations; i++) {
+        if (!args->map->insert(args->firstKey + i, i)) {
+            args->failures++;
+        }
+    }
+    for (uint32_t i = 0; i < args->operations; i++) {
+        uint32_t value = 0;
+
+        if (!args->map->find(args->firstKey + i, value) || value != i) {
+            args->failures++;
+        }
+    }
+
+    xTaskNotifyGive(args->mainTask);
+    vTaskDelete(nullptr);
+}
+
+// Starts one worker per core and waits for both. Returns the elapsed time in microseconds.
+template <class Args>
+static int64_t runOnBothCores(TaskFunction_t fn, Args *args)
+{
+    int64_t startUs = esp_timer_get_time();
+
+    for (BaseType_t core = 0; core < 2; core++) {
+        BaseType_t coreId = (portNUM_PROCESSORS > 1) ? core : tskNO_AFFINITY;
+        BaseType_t res = xTaskCreatePinnedToCore(fn, "map_worker", kTaskStackSize, &args[core], kTaskPriority, nullptr, coreId);
+
+        TEST_ASSERT_EQUAL(pdPASS, res);
+    }
+
+    uint32_t completed = 0;
+    while (completed < 2) {
+        uint32_t notified = ulTaskNotifyTake(pdTRUE, kTestTimeout);
+
+        TEST_ASSERT_NOT_EQUAL_UINT32(0, notified);
+        completed += notified;
+    }
+    return esp_timer_get_time() - startUs;
+}
+
+template <class Map>
+static int64_t runMixedWorkload(Map &map, uint32_t operations)
+{
+    WorkerArgs<Map> args[2] = {};
+
+    for (uint32_t key = 0; key < kKeyCount; key++) {
+        TEST_ASSERT_TRUE(map.insert(key, key));
+    }
+    for (int i = 0; i < 2; i++) {
+        args[i].map = &map;
+        args[i].mainTask = xTaskGetCurrentTaskHandle();
+        args[i].seed = 1000u + (uint32_t)i;
+        args[i].operations = operations;
+    }
+
+    int64_t elapsedUs = runOnBothCores(mixedWorkerTask<Map>, args);
+    TEST_ASSERT_EQUAL_UINT32(0, args[0].failures + args[1].failures);
+    return elapsedUs;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd concurrent_hash_map basic operations", "lightstd concurrent_hash_map")
+{
+    concurrent_hash_map<uint32_t, uint32_t, static_hash_map_default_hash<uint32_t>, 4> map;
+    uint32_t value = 0;
+    bool inserted = false;
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, map.init(0));
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(64));
+    TEST_ASSERT_TRUE(map.empty());
+
+    for (uint32_t i = 0; i < 32; i++) {
+        TEST_ASSERT_TRUE(map.insert(i, i * 2, &inserted));
+        TEST_ASSERT_TRUE(inserted);
+    }
+    TEST_ASSERT_TRUE(map.insert(5, 500, &inserted));
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_EQUAL_UINT32(32, map.size());
+
+    TEST_ASSERT_TRUE(map.find(5, value));
+    TEST_ASSERT_EQUAL_UINT32(500, value);
+    TEST_ASSERT_FALSE(map.find(99, value));
+    TEST_ASSERT_TRUE(map.visit(7, [](uint32_t& v) {
+        v += 1;
+    }));
+    TEST_ASSERT_TRUE(map.find(7, value));
+    TEST_ASSERT_EQUAL_UINT32(15, value);
+
+    TEST_ASSERT_TRUE(map.erase(7));
+    TEST_ASSERT_FALSE(map.contains(7));
+
+    uint32_t sum = 0;
+    map.for_each([&](const uint32_t& key, uint32_t&) {
+        sum += key;
+    });
+    TEST_ASSERT_EQUAL_UINT32(31 * 32 / 2 - 7, sum);
+
+    map.clear();
+    TEST_ASSERT_TRUE(map.empty());
+    map.done();
+}
+
+TEST_CASE("lightstd concurrent_hash_map concurrent inserts", "lightstd concurrent_hash_map")
+{
+    concurrent_hash_map<uint32_t, uint32_t> map;
+    WorkerArgs<concurrent_hash_map<uint32_t, uint32_t>> args[2] = {};
+
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(1024));
+    for (int i = 0; i < 2; i++) {
+        args[i].map = &map;
+        args[i].mainTask = xTaskGetCurrentTaskHandle();
+        args[i].operations = 300;
+        args[i].firstKey = (uint32_t)i * 10000u;
+    }
+
+    runOnBothCores(insertWorkerTask, args);
+    TEST_ASSERT_EQUAL_UINT32(0, args[0].failures + args[1].failures);
+    TEST_ASSERT_EQUAL_UINT32(600, map.size());
+}
+
+TEST_CASE("lightstd concurrent_hash_map two-core benchmark", "lightstd concurrent_hash_map benchmark")
+{
+    constexpr uint32_t kOperations = 20000;
+    LockedMap locked;
+    concurrent_hash_map<uint32_t, uint32_t> sharded;
+
+    TEST_ASSERT_EQUAL(ESP_OK, locked.init(kKeyCount * 2));
+    TEST_ASSERT_EQUAL(ESP_OK, sharded.init(kKeyCount * 2));
+
+    int64_t lockedUs = runMixedWorkload(locked, kOperations);
+    int64_t shardedUs = runMixedWorkload(sharded, kOperations);
+
+    printf("[bench] %-48s %8lu ops %10lld us\n", "RWMutex static_hash_map, 2 tasks", (unsigned long)(kOperations * 2),
+           (long long)lockedUs);
+    printf("[bench] %-48s %8lu ops %10lld us\n", "concurrent_hash_map (8 shards), 2 tasks", (unsigned long)(kOperations * 2),
+           (long long)shardedUs);
+}
@@ -0,0 +1,193 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <unity.h>
+#include "lightstd/flat_map.h"
+#include "lightstd/string.h"
+#include "lightstd/unordered_map.h"
+#include "benchmark.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd flat_map insert find erase", "lightstd flat_map")
+{
+    CountingAllocator alloc;
+    {
+        flat_map<int, int> map(&alloc);
+        bool inserted = false;
+
+        TEST_ASSERT_TRUE(map.empty());
+        TEST_ASSERT_NULL(map.find(1));
+
+        // Insert out of order; the map keeps the keys sorted.
+        static const int kKeys[] = {50, 10, 40, 20, 30, 0, 60};
+        for (int key : kKeys) {
+            TEST_ASSERT_NOT_NULL(map.insert(key, key * 2, &inserted));
+            TEST_ASSERT_TRUE(inserted);
+        }
+        TEST_ASSERT_EQUAL(41, *map.insert(20, 41, &inserted));
+        TEST_ASSERT_FALSE(inserted);
+        TEST_ASSERT_EQUAL_UINT32(7, map.size());
+
+        for (int key = -5; key <= 65; key++) {
+            const int *value = map.find(key);
+
+            TEST_ASSERT_EQUAL(key % 10 == 0 && key >= 0, value != nullptr);
+            if (value && key != 20) {
+                TEST_ASSERT_EQUAL(key * 2, *value);
+            }
+        }
+
+        // Ordered iteration and range scans.
+        int prev = -1;
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            TEST_ASSERT_GREATER_THAN(prev, it->key);
+            prev = it->key;
+        }
+        TEST_ASSERT_EQUAL(30, map.lower_bound(25)->key);
+        TEST_ASSERT_TRUE(map.lower_bound(61) == map.end());
+
+        TEST_ASSERT_TRUE(map.erase(0));
+        TEST_ASSERT_TRUE(map.erase(60));
+        TEST_ASSERT_FALSE(map.erase(60));
+        TEST_ASSERT_EQUAL(10, map.begin()->key);
+        TEST_ASSERT_EQUAL_UINT32(5, map.size());
+
+        map.clear();
+        TEST_ASSERT_TRUE(map.empty());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd flat_map bulk build", "lightstd flat_map")
+{
+    flat_map<uint32_t, uint32_t> map;
+    uint32_t seed = 7;
+
+    TEST_ASSERT_TRUE(map.reserve(300));
+    for (uint32_t i = 0; i < 300; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        TEST_ASSERT_TRUE(map.append((seed >> 8) % 200, i));
+    }
+    map.build();
+
+    // Duplicates collapse, so every key in range appears once and in order.
+    uint32_t prev = 0;
+    bool first = true;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        TEST_ASSERT_TRUE(first || it->key > prev);
+        TEST_ASSERT_NOT_NULL(map.find(it->key));
+        prev = it->key;
+        first = false;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(200, map.size());
+    TEST_ASSERT_TRUE(map.shrink_to_fit());
+
+    // Appending in key order keeps the map searchable without a build.
+    flat_map<int, int> ordered;
+    for (int i = 0; i < 10; i++) {
+        TEST_ASSERT_TRUE(ordered.append(i, -i));
+    }
+    TEST_ASSERT_EQUAL(-7, *ordered.find(7));
+}
+
+TEST_CASE("lightstd flat_map string keys", "lightstd flat_map")
+{
+    static const char *kCommands[] = {"reboot", "status", "ota", "wifi", "a command long enough to be stored on the heap"};
+    CountingAllocator alloc;
+    {
+        flat_map<string, int> dispatch(&alloc);
+
+        for (int i = 0; i < 5; i++) {
+            string name(&alloc);
+
+            TEST_ASSERT_TRUE(name.append(kCommands[i]));
+            TEST_ASSERT_TRUE(dispatch.append(std::move(name), i));
+        }
+        dispatch.build();
+
+        // Lookups by C string or view never build a temporary key.
+        size_t allocations = alloc.allocations;
+        TEST_ASSERT_EQUAL(2, *dispatch.find("ota"));
+        TEST_ASSERT_EQUAL(4, *dispatch.find(string_view(kCommands[4])));
+        TEST_ASSERT_TRUE(dispatch.contains("wifi"));
+        TEST_ASSERT_FALSE(dispatch.contains("wif"));
+        TEST_ASSERT_EQUAL_UINT32(allocations, alloc.allocations);
+
+        TEST_ASSERT_EQUAL_STRING("a command long enough to be stored on the heap", dispatch.begin()->key.c_str());
+        TEST_ASSERT_TRUE(dispatch.erase("reboot"));
+        TEST_ASSERT_EQUAL_UINT32(4, dispatch.size());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd flat_set", "lightstd flat_map")
+{
+    flat_set<uint16_t> set;
+    bool inserted = false;
+
+    TEST_ASSERT_TRUE(set.insert(8, &inserted));
+    TEST_ASSERT_TRUE(inserted);
+    TEST_ASSERT_TRUE(set.insert(8, &inserted));
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_TRUE(set.append(3));
+    TEST_ASSERT_TRUE(set.append(5));
+    TEST_ASSERT_TRUE(set.append(3));
+    set.build();
+
+    static const uint16_t kExpected[] = {3, 5, 8};
+    size_t idx = 0;
+    for (uint16_t key : set) {
+        TEST_ASSERT_EQUAL_UINT32(kExpected[idx++], key);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, idx);
+    TEST_ASSERT_TRUE(set.contains(5));
+    TEST_ASSERT_FALSE(set.contains(4));
+    TEST_ASSERT_EQUAL_UINT32(5, *set.lower_bound(4));
+    TEST_ASSERT_TRUE(set.erase(5));
+    TEST_ASSERT_FALSE(set.contains(5));
+}
+
+TEST_CASE("lightstd flat_map vs static_hash_map benchmark", "lightstd flat_map benchmark")
+{
+    static const size_t kSizes[] = {16, 64, 256, 1024};
+    constexpr uint32_t kLookups = 20000;
+    char label[64];
+
+    for (size_t entries : kSizes) {
+        flat_map<uint32_t, uint32_t> flat;
+        static_hash_map<uint32_t, uint32_t> hashed;
+
+        // Same sparse keys in both, hash map sized for a 75% load.
+        TEST_ASSERT_EQUAL(ESP_OK, hashed.init(entries * 4 / 3 + 1));
+        TEST_ASSERT_TRUE(flat.reserve(entries));
+        for (uint32_t i = 0; i < entries; i++) {
+            TEST_ASSERT_TRUE(flat.append(i * 2654435761u, i));
+            TEST_ASSERT_NOT_NULL(hashed.insert(i * 2654435761u, i));
+        }
+        flat.build();
+        printf("[bench] %lu entries: flat_map %lu bytes, static_hash_map %lu bytes\n", (unsigned long)entries,
+               (unsigned long)(entries * sizeof(flat_map<uint32_t, uint32_t>::Entry_t)),
+               (unsigned long)((entries * 4 / 3 + 1) * static_hash_map<uint32_t, uint32_t>::bytes_per_slot));
+
+        snprintf(label, sizeof(label), "flat_map %lu entries hit lookup", (unsigned long)entries);
+        benchmarkRun(label, kLookups, [&](uint32_t i) {
+            benchmarkKeep(flat.find((i % entries) * 2654435761u));
+        });
+        snprintf(label, sizeof(label), "static_hash_map %lu entries hit lookup", (unsigned long)entries);
+        benchmarkRun(label, kLookups, [&](uint32_t i) {
+            benchmarkKeep(hashed.find((i % entries) * 2654435761u));
+        });
+        snprintf(label, sizeof(label), "flat_map %lu entries miss lookup", (unsigned long)entries);
+        benchmarkRun(label, kLookups, [&](uint32_t i) {
+            benchmarkKeep(flat.find(i * 2654435761u + 1));
+        });
+        snprintf(label, sizeof(label), "static_hash_map %lu entries miss lookup", (unsigned long)entries);
+        benchmarkRun(label, kLookups, [&](uint32_t i) {
+            benchmarkKeep(hashed.find(i * 2654435761u + 1));
+        });
+    }
+}
@@ -1,6 +1,13 @@
+#include <stdint.h>
+#include <functional>
+#include <memory>
 #include <utility>
 #include <unity.h>
 #include "lightstd/functional.h"
+#include "lightstd/string.h"
+#include "lightstd/vector.h"
+#include "benchmark.h"
+#include "counting_allocator.h"
 
 using namespace lightstd;
 
@@ -25,4 +32,281 @@ TEST_CASE("lightstd light_function copy move and reset", "lightstd functional")
 
     moved = nullptr;
     TEST_ASSERT_FALSE((bool)moved);
+    TEST_ASSERT_TRUE(moved == nullptr);
+    TEST_ASSERT_TRUE(nullptr != fn);
+}
+
+namespace {
+
+struct DestroyCounter
+{
+    int *destroyed;
+    int base;
+
+    DestroyCounter(int *_destroyed, int _base) : destroyed(_destroyed), base(_base)
+    {
+    }
+
+    DestroyCounter(const DestroyCounter& other) noexcept : destroyed(other.destroyed), base(other.base)
+    {
+    }
+
+    ~DestroyCounter()
+    {
+        (*destroyed)++;
+    }
+
+    int operator()(int x) const
+    {
+        return base + x;
+    }
+};
+
+struct Accumulator
+{
+    uint32_t total = 0;
+
+    void operator()(uint32_t v)
+    {
+        total += v;
+    }
+};
+
+static uint32_t gBenchTotal = 0;
+
+static void addToTotal(uint32_t v)
+{
+    gBenchTotal += v;
+}
+
+static int twice(int x)
+{
+    return x * 2;
+}
+
+} // namespace
+
+TEST_CASE("lightstd light_function trivially copyable and heap callables", "lightstd functional")
+{
+    // Captures a pointer and an int: trivially copyable, relocated by memcpy.
+    int sum = 0;
+    int step = 3;
+    light_function<void()> add = [&sum, step]() {
+        sum += step;
+    };
+    light_function<void()> addCopy(add);
+    light_function<void()> addMoved(std::move(add));
+
+    TEST_ASSERT_FALSE((bool)add);
+    addCopy();
+    addMoved();
+    TEST_ASSERT_EQUAL(6, sum);
+
+    // Larger than the inline buffer: lives on the heap and is still copied bytewise.
+    uint32_t big[16];
+    for (uint32_t i = 0; i < 16; i++) {
+        big[i] = i;
+    }
+    light_function<uint32_t()> heapFn = [big]() {
+        uint32_t total = 0;
+        for (uint32_t v : big) {
+            total += v;
+        }
+        return total;
+    };
+    light_function<uint32_t()> heapCopy(heapFn);
+    heapFn = nullptr;
+    TEST_ASSERT_EQUAL_UINT32(120, heapCopy());
+
+    // Non-trivial callables still go through their copy constructor and destructor.
+    int destroyed = 0;
+    {
+        light_function<int(int)> fn = DestroyCounter(&destroyed, 10);
+        int afterStore = destroyed;
+        light_function<int(int)> copy(fn);
+
+        TEST_ASSERT_EQUAL(11, copy(1));
+        fn = nullptr;
+        TEST_ASSERT_EQUAL(afterStore + 1, destroyed);
+    }
+    TEST_ASSERT_GREATER_THAN(2, destroyed);
+
+    // Same for one stored inline: copying it must not duplicate its bytes.
+    std::shared_ptr<int> shared = std::make_shared<int>(7);
+    {
+        light_function<int()> owner = [shared]() {
+            return *shared;
+        };
+        light_function<int()> ownerCopy(owner);
+
+        TEST_ASSERT_EQUAL(3, shared.use_count());
+        owner = nullptr;
+        TEST_ASSERT_EQUAL(7, ownerCopy());
+    }
+    TEST_ASSERT_EQUAL(1, shared.use_count());
+}
+
+TEST_CASE("lightstd unique_function move-only callables", "lightstd functional")
+{
+    CountingAllocator alloc;
+    {
+        vector<uint8_t> payload(&alloc);
+        for (uint8_t i = 0; i < 100; i++) {
+            TEST_ASSERT_TRUE(payload.push_back(i));
+        }
+        const uint8_t *data = payload.data();
+        size_t allocations = alloc.allocations;
+
+        // The lambda owns the vector; moving the job around never copies the buffer.
+        unique_function<const uint8_t*(uint32_t*)> job = [buf = std::move(payload)](uint32_t *sum) mutable {
+            for (uint8_t v : buf) {
+                *sum += v;
+            }
+            return buf.data();
+        };
+        unique_function<const uint8_t*(uint32_t*)> moved(std::move(job));
+        unique_function<const uint8_t*(uint32_t*)> assigned;
+
+        TEST_ASSERT_FALSE((bool)job);
+        TEST_ASSERT_TRUE(job == nullptr);
+        assigned = std::move(moved);
+        TEST_ASSERT_TRUE(assigned != nullptr);
+
+        uint32_t sum = 0;
+        TEST_ASSERT_EQUAL_PTR(data, assigned(&sum));
+        TEST_ASSERT_EQUAL_UINT32(4950, sum);
+        TEST_ASSERT_EQUAL_UINT32(allocations, alloc.allocations);
+
+        // Resetting destroys the captured vector.
+        assigned = nullptr;
+        TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+
+        // Strings, swap and plain copyable callables work too.
+        string name(&alloc);
+        TEST_ASSERT_TRUE(name.append("sensor-7"));
+        unique_function<size_t()> length = [s = std::move(name)]() {
+            return s.length();
+        };
+        unique_function<size_t()> constant = []() {
+            return size_t(3);
+        };
+        length.swap(constant);
+        TEST_ASSERT_EQUAL_UINT32(3, length());
+        TEST_ASSERT_EQUAL_UINT32(8, constant());
+
+        // Callables larger than the inline buffer go to the heap and are stolen on move.
+        uint32_t big[16] = {};
+        big[15] = 42;
+        unique_function<uint32_t(), 8> heapFn = [big]() {
+            return big[15];
+        };
+        unique_function<uint32_t(), 8> heapMoved(std::move(heapFn));
+        TEST_ASSERT_EQUAL_UINT32(42, heapMoved());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd function_ref", "lightstd functional")
+{
+    // Plain function and function pointer.
+    function_ref<int(int)> ref = twice;
+    TEST_ASSERT_EQUAL(14, ref(7));
+    int (*fp)(int) = twice;
+    ref = fp;
+    TEST_ASSERT_EQUAL(8, ref(4));
+
+    // Stateful functor: calls reach the original object, never a copy.
+    Accumulator acc;
+    function_ref<void(uint32_t)> accRef = acc;
+    accRef(5);
+    accRef(6);
+    TEST_ASSERT_EQUAL_UINT32(11, acc.total);
+
+    // A copy refers to the same callable.
+    function_ref<void(uint32_t)> accRef2 = accRef;
+    accRef2(1);
+    TEST_ASSERT_EQUAL_UINT32(12, acc.total);
+
+    // Const callables and a light_function as the target.
+    const auto add = [](int a, int b) {
+        return a + b;
+    };
+    function_ref<int(int, int)> addRef = add;
+    TEST_ASSERT_EQUAL(9, addRef(4, 5));
+
+    light_function<int(int)> owned = [](int x) {
+        return x - 1;
+    };
+    function_ref<int(int)> ownedRef = owned;
+    TEST_ASSERT_EQUAL(41, ownedRef(42));
+
+    // Passing a temporary lambda as an argument is the intended use.
+    auto apply = [](function_ref<int(int)> fn, int v) {
+        return fn(v);
+    };
+    TEST_ASSERT_EQUAL(100, apply([](int x) { return x * x; }, 10));
+}
+
+TEST_CASE("lightstd functional call copy move benchmark", "lightstd functional benchmark")
+{
+    constexpr uint32_t kIters = 100000;
+    uint32_t total = 0;
+    auto capturing = [&total](uint32_t v) {
+        total += v;
+    };
+
+    // Call cost. The function pointer is volatile so the call is not inlined away.
+    void (* volatile rawFn)(uint32_t) = addToTotal;
+    function_ref<void(uint32_t)> ref = capturing;
+    light_function<void(uint32_t)> light = capturing;
+    std::function<void(uint32_t)> stdFn = capturing;
+
+    benchmarkRun("call raw function pointer", kIters, [&](uint32_t i) {
+        rawFn(i);
+    });
+    benchmarkRun("call function_ref", kIters, [&](uint32_t i) {
+        ref(i);
+    });
+    benchmarkRun("call light_function", kIters, [&](uint32_t i) {
+        light(i);
+    });
+    benchmarkRun("call std::function", kIters, [&](uint32_t i) {
+        stdFn(i);
+    });
+    benchmarkKeep(total);
+    benchmarkKeep(gBenchTotal);
+
+    // Copy cost of a trivially copyable capture.
+    benchmarkRun("copy light_function", kIters, [&](uint32_t) {
+        light_function<void(uint32_t)> copy(light);
+        benchmarkKeep(copy);
+    });
+    benchmarkRun("copy std::function", kIters, [&](uint32_t) {
+        std::function<void(uint32_t)> copy(stdFn);
+        benchmarkKeep(copy);
+    });
+
+    // Move cost, moving back and forth between two instances.
+    light_function<void(uint32_t)> lightOther;
+    std::function<void(uint32_t)> stdOther;
+    benchmarkRun("move light_function", kIters, [&](uint32_t i) {
+        if (i & 1) {
+            light = std::move(lightOther);
+        }
+        else {
+            lightOther = std::move(light);
+        }
+        benchmarkKeep(light);
+    });
+    benchmarkRun("move std::function", kIters, [&](uint32_t i) {
+        if (i & 1) {
+            stdFn = std::move(stdOther);
+        }
+        else {
+            stdOther = std::move(stdFn);
+        }
+        benchmarkKeep(stdFn);
+    });
+    TEST_ASSERT_TRUE((bool)light);
+    TEST_ASSERT_TRUE((bool)stdFn);
 }
@@ -0,0 +1,172 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <unity.h>
+#include "lightstd/lru_cache.h"
+#include "lightstd/string.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+// Sends every key to the same bucket so eviction has to repair long probe runs.
+struct CollidingHash
+{
+    uint32_t operator()(const int&) const
+    {
+        return 7;
+    }
+};
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd lru_cache evicts least recently used", "lightstd lru_cache")
+{
+    lru_cache<int, int> cache;
+    int evictedKeys[8];
+    size_t evicted = 0;
+
+    TEST_ASSERT_NULL(cache.put(1, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, cache.init(0));
+    TEST_ASSERT_EQUAL(ESP_OK, cache.init(3));
+    cache.set_evict_callback([&](const int& key, int& value) {
+        TEST_ASSERT_EQUAL(key * 10, value);
+        evictedKeys[evicted++] = key;
+    });
+
+    TEST_ASSERT_NOT_NULL(cache.put(1, 10));
+    TEST_ASSERT_NOT_NULL(cache.put(2, 20));
+    TEST_ASSERT_NOT_NULL(cache.put(3, 30));
+
+    // Touch 1 so that 2 becomes the oldest entry.
+    TEST_ASSERT_EQUAL(10, *cache.get(1));
+    TEST_ASSERT_NOT_NULL(cache.put(4, 40));
+    TEST_ASSERT_EQUAL_UINT32(1, evicted);
+    TEST_ASSERT_EQUAL(2, evictedKeys[0]);
+    TEST_ASSERT_NULL(cache.get(2));
+
+    // peek() does not refresh recency, so 3 is evicted next.
+    TEST_ASSERT_EQUAL(30, *cache.peek(3));
+    TEST_ASSERT_NOT_NULL(cache.put(5, 50));
+    TEST_ASSERT_EQUAL(3, evictedKeys[1]);
+
+    // Updating an existing key refreshes it without evicting.
+    TEST_ASSERT_EQUAL(10, *cache.put(1, 10));
+    TEST_ASSERT_EQUAL_UINT32(2, evicted);
+    TEST_ASSERT_EQUAL_UINT32(3, cache.size());
+
+    int order[3];
+    size_t idx = 0;
+    cache.for_each([&](const int& key, int&) {
+        order[idx++] = key;
+    });
+    TEST_ASSERT_EQUAL(1, order[0]);
+    TEST_ASSERT_EQUAL(5, order[1]);
+    TEST_ASSERT_EQUAL(4, order[2]);
+
+    TEST_ASSERT_EQUAL_UINT32(1, cache.hit_count());
+    TEST_ASSERT_EQUAL_UINT32(1, cache.miss_count());
+    TEST_ASSERT_EQUAL_UINT32(2, cache.eviction_count());
+
+    // erase() and clear() do not report evictions.
+    TEST_ASSERT_TRUE(cache.erase(5));
+    TEST_ASSERT_FALSE(cache.erase(5));
+    TEST_ASSERT_TRUE(cache.evict());
+    TEST_ASSERT_EQUAL(4, evictedKeys[2]);
+    cache.clear();
+    TEST_ASSERT_TRUE(cache.empty());
+    TEST_ASSERT_FALSE(cache.evict());
+    TEST_ASSERT_EQUAL_UINT32(3, evicted);
+}
+
+TEST_CASE("lightstd lru_cache matches reference model", "lightstd lru_cache")
+{
+    constexpr int kCapacity = 6;
+    lru_cache<int, int, CollidingHash> cache;
+    int model[kCapacity]; // Most recently used first
+    int modelSize = 0;
+    uint32_t seed = 2024;
+
+    TEST_ASSERT_EQUAL(ESP_OK, cache.init(kCapacity));
+    for (int round = 0; round < 5000; round++) {
+        seed = seed * 1664525u + 1013904223u;
+
+        int key = (int)((seed >> 8) % 12);
+        int pos = -1;
+        for (int i = 0; i < modelSize; i++) {
+            if (model[i] == key) {
+                pos = i;
+            }
+        }
+
+        switch ((seed >> 4) % 3) {
+            case 0: {
+                int *value = cache.get(key);
+
+                TEST_ASSERT_EQUAL(pos >= 0, value != nullptr);
+                if (value) {
+                    TEST_ASSERT_EQUAL(key, *value);
+                }
+                break;
+            }
+            case 1:
+                TEST_ASSERT_NOT_NULL(cache.put(key, key));
+                if (pos < 0) {
+                    pos = (modelSize < kCapacity) ? modelSize++ : kCapacity - 1;
+                }
+                break;
+            default:
+                TEST_ASSERT_EQUAL(pos >= 0, cache.erase(key));
+                if (pos >= 0) {
+                    for (int i = pos; i + 1 < modelSize; i++) {
+                        model[i] = model[i + 1];
+                    }
+                    modelSize--;
+                }
+                pos = -1;
+                break;
+        }
+        // Move the touched key to the front.
+        if (pos >= 0) {
+            for (int i = pos; i > 0; i--) {
+                model[i] = model[i - 1];
+            }
+            model[0] = key;
+        }
+
+        TEST_ASSERT_EQUAL_UINT32(modelSize, cache.size());
+        int idx = 0;
+        cache.for_each([&](const int& k, int&) {
+            TEST_ASSERT_EQUAL(model[idx], k);
+            idx++;
+        });
+    }
+}
+
+TEST_CASE("lightstd lru_cache non-trivial values", "lightstd lru_cache")
+{
+    CountingAllocator alloc;
+    {
+        lru_cache<string, string> cache;
+        string lastEvicted(&alloc);
+
+        TEST_ASSERT_EQUAL(ESP_OK, cache.init(4));
+        cache.set_evict_callback([&](const string&, string& value) {
+            lastEvicted = std::move(value);
+        });
+        for (int i = 0; i < 10; i++) {
+            string key(&alloc);
+            string value(&alloc);
+
+            TEST_ASSERT_TRUE(key.appendf("host-%d.example.com with a long enough name", i));
+            TEST_ASSERT_TRUE(value.appendf("10.0.0.%d and more text so it is heap allocated", i));
+            TEST_ASSERT_NOT_NULL(cache.put(std::move(key), std::move(value)));
+        }
+        TEST_ASSERT_EQUAL_UINT32(4, cache.size());
+        TEST_ASSERT_EQUAL_STRING("10.0.0.5 and more text so it is heap allocated", lastEvicted.c_str());
+        TEST_ASSERT_NOT_NULL(cache.get("host-9.example.com with a long enough name"));
+        TEST_ASSERT_NULL(cache.get("host-0.example.com with a long enough name"));
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
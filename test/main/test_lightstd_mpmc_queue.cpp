@@ -0,0 +1,285 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
+#include <unity.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <stdatomic.h>
+#include "lightstd/functional.h"
+#include "lightstd/mpmc_queue.h"
+#include "lightstd/vector.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+static constexpr UBaseType_t kTaskPriority = tskIDLE_PRIORITY + 1;
+static constexpr uint32_t kTaskStackSize = 4096;
+static constexpr TickType_t kTestTimeout = pdMS_TO_TICKS(10000);
+static constexpr uint32_t kMaxWorkers = 4;
+
+// -----------------------------------------------------------------------------
+
+namespace {
+
+// Shared state for one producers/consumers run over either queue kind.
+struct Workload
+{
+    mpmc_queue<uint32_t> *queue;
+    QueueHandle_t rtosQueue;
+    TaskHandle_t mainTask;
+    uint32_t itemsPerProducer;
+    uint32_t totalItems;
+    _Atomic(uint32_t) consumed;
+    _Atomic(uint32_t) checksum;
+};
+
+struct WorkerArgs
+{
+    Workload *work;
+    uint32_t id;
+};
+
+// Pushes itemsPerProducer values, blocking while the queue is full.
+static void producerTask(void *arg)
+{
+    WorkerArgs *args = static_cast<WorkerArgs *>(arg);
+    Workload *work = args->work;
+
+    for (uint32_t i = 0; i < work->itemsPerProducer; i++) {
+        uint32_t value = args->id * work->itemsPerProducer + i;
+
+        if (work->queue) {
+            work->queue->push(value);
+        }
+        else {
+            xQueueSend(work->rtosQueue, &value, portMAX_DELAY);
+        }
+    }
+
+    xTaskNotifyGive(work->mainTask);
+    vTaskDelete(nullptr);
+}
+
+// Pops until every produced item has been consumed by some consumer.
+static void consumerTask(void *arg)
+{
+    WorkerArgs *args = static_cast<WorkerArgs *>(arg);
+    Workload *work = args->work;
+
+    while (atomic_load_explicit(&work->consumed, memory_order_relaxed) < work->totalItems) {
+        uint32_t value;
+        bool ok;
+
+        if (work->queue) {
+            ok = work->queue->pop(value, pdMS_TO_TICKS(10));
+        }
+        else {
+            ok = xQueueReceive(work->rtosQueue, &value, pdMS_TO_TICKS(10)) == pdTRUE;
+        }
+        if (ok) {
+            atomic_fetch_add_explicit(&work->checksum, value, memory_order_relaxed);
+            atomic_fetch_add_explicit(&work->consumed, 1u, memory_order_relaxed);
+        }
+    }
+
+    xTaskNotifyGive(work->mainTask);
+    vTaskDelete(nullptr);
+}
+
+// Runs producers and consumers to completion, checks every item arrived once and returns the elapsed time.
+static int64_t runWorkload(mpmc_queue<uint32_t> *queue, QueueHandle_t rtosQueue, uint32_t producers,
+                           uint32_t consumers, uint32_t itemsPerProducer)
+{
+    Workload work = {};
+    WorkerArgs producerArgs[kMaxWorkers];
+    WorkerArgs consumerArgs[kMaxWorkers];
+    uint32_t expectedChecksum = 0;
+    uint32_t completed = 0;
+    int64_t startUs;
+
+    work.queue = queue;
+    work.rtosQueue = rtosQueue;
+    work.mainTask = xTaskGetCurrentTaskHandle();
+    work.itemsPerProducer = itemsPerProducer;
+    work.totalItems = producers * itemsPerProducer;
+    atomic_init(&work.consumed, 0u);
+    atomic_init(&work.checksum, 0u);
+    for (uint32_t v = 0; v < work.totalItems; v++) {
+        expectedChecksum += v;
+    }
+
+    startUs = esp_timer_get_time();
+    for (uint32_t i = 0; i < consumers; i++) {
+        consumerArgs[i] = {&work, i};
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(consumerTask, "mpmc_consumer", kTaskStackSize, &consumerArgs[i],
+                                                          kTaskPriority, nullptr, tskNO_AFFINITY));
+    }
+    for (uint32_t i = 0; i < producers; i++) {
+        producerArgs[i] = {&work, i};
+        TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(producerTask, "mpmc_producer", kTaskStackSize, &producerArgs[i],
+                                                          kTaskPriority, nullptr, tskNO_AFFINITY));
+    }
+    while (completed < producers + consumers) {
+        uint32_t notified = ulTaskNotifyTake(pdTRUE, kTestTimeout);
+
+        TEST_ASSERT_NOT_EQUAL_UINT32(0, notified);
+        completed += notified;
+    }
+    int64_t elapsedUs = esp_timer_get_time() - startUs;
+
+    TEST_ASSERT_EQUAL_UINT32(work.totalItems, atomic_load(&work.consumed));
+    TEST_ASSERT_EQUAL_UINT32(expectedChecksum, atomic_load(&work.checksum));
+    return elapsedUs;
+}
+
+struct ParkedPop
+{
+    mpmc_queue<uint32_t> *queue;
+    TaskHandle_t mainTask;
+    uint32_t value;
+    bool ok;
+};
+
+static void parkedPopTask(void *arg)
+{
+    ParkedPop *args = static_cast<ParkedPop *>(arg);
+
+    args->ok = args->queue->pop(args->value, kTestTimeout);
+
+    xTaskNotifyGive(args->mainTask);
+    vTaskDelete(nullptr);
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd mpmc_queue single task", "lightstd mpmc_queue")
+{
+    CountingAllocator alloc;
+    {
+        mpmc_queue<uint32_t> queue(&alloc);
+        uint32_t value = 0;
+
+        TEST_ASSERT_FALSE(queue.try_push(1u));
+        TEST_ASSERT_FALSE(queue.try_pop(value));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, queue.init(0));
+        TEST_ASSERT_EQUAL(ESP_OK, queue.init(5));
+        TEST_ASSERT_EQUAL_UINT32(8, queue.capacity());
+
+        // FIFO order across several laps.
+        for (uint32_t lap = 0; lap < 3; lap++) {
+            for (uint32_t i = 0; i < 8; i++) {
+                TEST_ASSERT_TRUE(queue.try_push(lap * 8 + i));
+            }
+            TEST_ASSERT_FALSE(queue.try_push(99u));
+            TEST_ASSERT_EQUAL_UINT32(8, queue.size_approx());
+            for (uint32_t i = 0; i < 8; i++) {
+                TEST_ASSERT_TRUE(queue.try_pop(value));
+                TEST_ASSERT_EQUAL_UINT32(lap * 8 + i, value);
+            }
+            TEST_ASSERT_FALSE(queue.try_pop(value));
+        }
+
+        // Blocking calls give up after the timeout.
+        int64_t startUs = esp_timer_get_time();
+        TEST_ASSERT_FALSE(queue.pop(value, pdMS_TO_TICKS(20)));
+        TEST_ASSERT_TRUE(esp_timer_get_time() - startUs >= 15000);
+        TEST_ASSERT_FALSE(queue.pop(value, 0));
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd mpmc_queue move-only items", "lightstd mpmc_queue")
+{
+    CountingAllocator alloc;
+    {
+        mpmc_queue<unique_function<uint32_t()>> jobs;
+        unique_function<uint32_t()> job;
+
+        TEST_ASSERT_EQUAL(ESP_OK, jobs.init(4));
+        for (uint32_t i = 0; i < 3; i++) {
+            vector<uint32_t> data(&alloc);
+
+            TEST_ASSERT_TRUE(data.push_back(i));
+            TEST_ASSERT_TRUE(data.push_back(i * 10));
+            auto sum = [d = std::move(data)]() {
+                return d[0] + d[1];
+            };
+            TEST_ASSERT_TRUE(jobs.try_emplace(std::move(sum)));
+        }
+        TEST_ASSERT_TRUE(jobs.pop(job, 0));
+        TEST_ASSERT_EQUAL_UINT32(0, job());
+        TEST_ASSERT_TRUE(jobs.pop(job, 0));
+        TEST_ASSERT_EQUAL_UINT32(11, job());
+
+        // The job left in the queue is destroyed with it.
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd mpmc_queue blocking wake-up", "lightstd mpmc_queue")
+{
+    mpmc_queue<uint32_t> queue;
+    ParkedPop args = {};
+
+    TEST_ASSERT_EQUAL(ESP_OK, queue.init(2));
+    args.queue = &queue;
+    args.mainTask = xTaskGetCurrentTaskHandle();
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(parkedPopTask, "mpmc_parked", kTaskStackSize, &args,
+                                                      kTaskPriority, nullptr, tskNO_AFFINITY));
+
+    // Give the consumer time to park, then a push must wake it.
+    vTaskDelay(pdMS_TO_TICKS(50));
+    TEST_ASSERT_TRUE(queue.push(42u, 0));
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, ulTaskNotifyTake(pdTRUE, kTestTimeout));
+    TEST_ASSERT_TRUE(args.ok);
+    TEST_ASSERT_EQUAL_UINT32(42, args.value);
+
+    // Full queue: push waits for room and times out.
+    TEST_ASSERT_TRUE(queue.try_push(1u));
+    TEST_ASSERT_TRUE(queue.try_push(2u));
+    TEST_ASSERT_FALSE(queue.push(3u, pdMS_TO_TICKS(10)));
+    TEST_ASSERT_TRUE(queue.pop(args.value, 0));
+    TEST_ASSERT_TRUE(queue.pop(args.value, 0));
+    TEST_ASSERT_EQUAL_UINT32(2, args.value);
+
+    // Many producers and consumers hand over every item exactly once.
+    runWorkload(&queue, nullptr, 4, 4, 5000);
+}
+
+// The test app only runs on the device, so producers and consumers are FreeRTOS tasks spread over the cores
+// instead of host threads, and the baseline is the FreeRTOS queue the component would otherwise use.
+TEST_CASE("lightstd mpmc_queue vs queue benchmark", "lightstd mpmc_queue benchmark")
+{
+    static const uint32_t kConfigs[][2] = {{1, 1}, {2, 2}, {4, 4}, {1, 4}, {4, 1}};
+    constexpr uint32_t kItems = 40000;
+    char label[64];
+
+    for (const auto& config : kConfigs) {
+        uint32_t producers = config[0];
+        uint32_t consumers = config[1];
+        mpmc_queue<uint32_t> queue;
+        QueueHandle_t rtosQueue = xQueueCreate(64, sizeof(uint32_t));
+        int64_t elapsedUs;
+
+        TEST_ASSERT_EQUAL(ESP_OK, queue.init(64));
+        TEST_ASSERT_NOT_NULL(rtosQueue);
+
+        elapsedUs = runWorkload(&queue, nullptr, producers, consumers, kItems / producers);
+        snprintf(label, sizeof(label), "mpmc_queue %lup/%luc", (unsigned long)producers, (unsigned long)consumers);
+        printf("[bench] %-48s %8lu ops %10lld us %10.0f ops/s\n", label, (unsigned long)kItems, (long long)elapsedUs,
+               (double)kItems * 1000000.0 / (double)(elapsedUs ? elapsedUs : 1));
+
+        elapsedUs = runWorkload(nullptr, rtosQueue, producers, consumers, kItems / producers);
+        snprintf(label, sizeof(label), "FreeRTOS queue %lup/%luc", (unsigned long)producers, (unsigned long)consumers);
+        printf("[bench] %-48s %8lu ops %10lld us %10.0f ops/s\n", label, (unsigned long)kItems, (long long)elapsedUs,
+               (double)kItems * 1000000.0 / (double)(elapsedUs ? elapsedUs : 1));
+
+        vQueueDelete(rtosQueue);
+    }
+}
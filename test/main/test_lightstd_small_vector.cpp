@@ -0,0 +1,88 @@
+#include <unity.h>
+#include "lightstd/small_vector.h"
+#include "lightstd/string.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd small_vector stays inline up to N", "lightstd small_vector")
+{
+    CountingAllocator alloc;
+    small_vector<int, 4> v(&alloc);
+
+    TEST_ASSERT_TRUE(v.is_inline());
+    TEST_ASSERT_EQUAL_UINT32(4, v.capacity());
+
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_TRUE(v.push_back(i));
+    }
+    TEST_ASSERT_TRUE(v.is_inline());
+    TEST_ASSERT_EQUAL_UINT32(0, alloc.allocations);
+
+    TEST_ASSERT_TRUE(v.push_back(4));
+    TEST_ASSERT_FALSE(v.is_inline());
+    TEST_ASSERT_EQUAL_UINT32(1, alloc.allocations);
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(i, v[i]);
+    }
+
+    // Shrinking back below N returns to the inline buffer.
+    v.resize_down(2);
+    TEST_ASSERT_TRUE(v.shrink_to_fit());
+    TEST_ASSERT_TRUE(v.is_inline());
+    TEST_ASSERT_EQUAL_UINT32(1, alloc.deallocations);
+    TEST_ASSERT_EQUAL(0, v[0]);
+    TEST_ASSERT_EQUAL(1, v[1]);
+}
+
+TEST_CASE("lightstd small_vector move keeps elements", "lightstd small_vector")
+{
+    CountingAllocator alloc;
+    small_vector<vector<int>, 2> a(&alloc);
+    vector<int> inner;
+
+    TEST_ASSERT_TRUE(inner.push_back(42));
+    TEST_ASSERT_TRUE(a.push_back(std::move(inner)));
+
+    small_vector<vector<int>, 2> b(std::move(a));
+    TEST_ASSERT_TRUE(a.empty());
+    TEST_ASSERT_TRUE(b.is_inline());
+    TEST_ASSERT_EQUAL_UINT32(1, b.size());
+    TEST_ASSERT_EQUAL(42, b[0][0]);
+
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(b.emplace_back());
+    }
+    TEST_ASSERT_FALSE(b.is_inline());
+
+    a = std::move(b);
+    TEST_ASSERT_TRUE(b.empty());
+    TEST_ASSERT_TRUE(b.is_inline());
+    TEST_ASSERT_EQUAL_UINT32(4, a.size());
+    TEST_ASSERT_EQUAL(42, a[0][0]);
+    TEST_ASSERT_EQUAL_UINT32(1, alloc.allocations);
+}
+
+TEST_CASE("lightstd small_vector pop_back destroys once", "lightstd small_vector")
+{
+    CountingAllocator alloc;
+    {
+        small_vector<string, 2> v(&alloc);
+
+        for (int i = 0; i < 3; i++) {
+            string s(&alloc);
+
+            TEST_ASSERT_TRUE(s.append("a string long enough to live on the heap"));
+            TEST_ASSERT_TRUE(v.push_back(std::move(s)));
+        }
+        v.pop_back();
+        v.pop_back();
+        TEST_ASSERT_EQUAL_UINT32(1, v.size());
+        TEST_ASSERT_EQUAL_STRING("a string long enough to live on the heap", v.back().c_str());
+        v.pop_back();
+        TEST_ASSERT_TRUE(v.empty());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
@@ -0,0 +1,101 @@
+#include <string.h>
+#include <unity.h>
+#include "convert.h"
+#include "fnv.h"
+#include "growable_buffer.h"
+#include "lightstd/span.h"
+#include "lightstd/string.h"
+#include "lightstd/string_view.h"
+#include "lightstd/vector.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+static size_t sumBytes(span<const uint8_t> bytes)
+{
+    size_t sum = 0;
+
+    for (uint8_t b : bytes) {
+        sum += b;
+    }
+    return sum;
+}
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd span conversions and slicing", "lightstd span")
+{
+    vector<uint8_t> v;
+    const uint8_t raw[] = {1, 2, 3, 4, 5};
+
+    TEST_ASSERT_TRUE(v.append(raw, sizeof(raw)));
+    TEST_ASSERT_EQUAL_UINT32(15, sumBytes(v));
+    TEST_ASSERT_EQUAL_UINT32(15, sumBytes(raw));
+
+    span<uint8_t> all(v);
+    TEST_ASSERT_EQUAL_UINT32(5, all.size());
+    TEST_ASSERT_EQUAL_UINT32(2, all.subspan(1, 2).size());
+    TEST_ASSERT_EQUAL_UINT8(2, all.subspan(1, 2)[0]);
+    TEST_ASSERT_EQUAL_UINT32(0, all.subspan(9).size());
+    TEST_ASSERT_EQUAL_UINT8(1, all.first(2).front());
+    TEST_ASSERT_EQUAL_UINT8(5, all.last(2).back());
+
+    span<const uint8_t> constView = all;
+    TEST_ASSERT_TRUE(constView == span<const uint8_t>(raw));
+    all[0] = 9;
+    TEST_ASSERT_TRUE(constView != span<const uint8_t>(raw));
+
+    GrowableBuffer_t gb = GB_STATIC_INIT;
+    TEST_ASSERT_TRUE(gbAdd(&gb, raw, 3));
+    TEST_ASSERT_EQUAL_UINT32(6, sumBytes(gb));
+    gbReset(&gb, true);
+}
+
+TEST_CASE("lightstd string_view compare and substr", "lightstd string_view")
+{
+    string s;
+
+    TEST_ASSERT_TRUE(s.append("devices/42/status"));
+
+    string_view view(s);
+    TEST_ASSERT_EQUAL_UINT32(17, view.length());
+    TEST_ASSERT_TRUE(view.substr(0, 7) == "devices");
+    TEST_ASSERT_TRUE(view.substr(8, 2) == string_view("42"));
+    TEST_ASSERT_TRUE(view.substr(11) == "status");
+    TEST_ASSERT_TRUE(view.substr(99).empty());
+
+    TEST_ASSERT_TRUE(string_view("abc") < string_view("abd"));
+    TEST_ASSERT_TRUE(string_view("ab") < string_view("abc"));
+    TEST_ASSERT_EQUAL(0, string_view("abc").compare("abc"));
+
+    view.remove_prefix(8);
+    view.remove_suffix(7);
+    TEST_ASSERT_TRUE(view == "42");
+}
+
+TEST_CASE("span overloads of fnv and convert", "lightstd span")
+{
+    vector<uint8_t> v;
+    const uint8_t raw[] = {0xDE, 0xAD, 0xBE, 0xEF, 0x00};
+    char text[16];
+    size_t textLen = sizeof(text);
+    uint8_t decoded[8];
+    size_t decodedLen = sizeof(decoded);
+
+    TEST_ASSERT_TRUE(v.append(raw, sizeof(raw)));
+    TEST_ASSERT_EQUAL_HEX32(fnv1a32(raw, 4), fnv1a32(span<const uint8_t>(v).first(4)));
+
+    TEST_ASSERT_TRUE(toHex(span<const uint8_t>(v).first(4), text, &textLen));
+    TEST_ASSERT_EQUAL_UINT32(8, textLen);
+    TEST_ASSERT_TRUE(fromHex(string_view(text, textLen).substr(2, 4), decoded, &decodedLen));
+    TEST_ASSERT_EQUAL_UINT32(2, decodedLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(raw + 1, decoded, 2);
+
+    textLen = sizeof(text);
+    decodedLen = sizeof(decoded);
+    TEST_ASSERT_TRUE(toB64(v, false, text, &textLen));
+    TEST_ASSERT_TRUE(fromB64(string_view(text, textLen), false, decoded, &decodedLen));
+    TEST_ASSERT_EQUAL_UINT32(sizeof(raw), decodedLen);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(raw, decoded, sizeof(raw));
+}
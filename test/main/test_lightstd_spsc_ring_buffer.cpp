@@ -0,0 +1,297 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "lightstd/spsc_ring_buffer.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+static constexpr UBaseType_t kTaskPriority = tskIDLE_PRIORITY + 1;
+static constexpr uint32_t kTaskStackSize = 4096;
+static constexpr TickType_t kTestTimeout = pdMS_TO_TICKS(10000);
+
+// -----------------------------------------------------------------------------
+
+struct StreamArgs
+{
+    spsc_ring_buffer<uint8_t> *ring;
+    QueueHandle_t queue;
+    TaskHandle_t mainTask;
+    uint32_t totalBytes;
+    uint32_t chunkSize;
+};
+
+// Writes a counting byte pattern in chunks of varying size, alternating write() and write_span().
+static void ringProducerTask(void *arg)
+{
+    StreamArgs *args = static_cast<StreamArgs *>(arg);
+    uint8_t chunk[97];
+    uint32_t sent = 0;
+    uint32_t seed = 12345;
+
+    while (sent < args->totalBytes) {
+        uint32_t len;
+
+        seed = seed * 1664525u + 1013904223u;
+        len = 1 + (seed >> 8) % sizeof(chunk);
+        if (len > args->totalBytes - sent) {
+            len = args->totalBytes - sent;
+        }
+        if (seed & 0x10000) {
+            for (uint32_t i = 0; i < len; i++) {
+                chunk[i] = (uint8_t)(sent + i);
+            }
+            for (uint32_t done = 0; done < len;) {
+                size_t written = args->ring->write(chunk + done, len - done);
+
+                if (written == 0) {
+                    taskYIELD();
+                }
+                done += (uint32_t)written;
+            }
+        }
+        else {
+            for (uint32_t done = 0; done < len;) {
+                span<uint8_t> region = args->ring->write_span();
+                size_t n = (region.size() < len - done) ? region.size() : len - done;
+
+                if (n == 0) {
+                    taskYIELD();
+                    continue;
+                }
+                for (size_t i = 0; i < n; i++) {
+                    region[i] = (uint8_t)(sent + done + i);
+                }
+                args->ring->commit_write(n);
+                done += (uint32_t)n;
+            }
+        }
+        sent += len;
+    }
+
+    xTaskNotifyGive(args->mainTask);
+    vTaskDelete(nullptr);
+}
+
+// Streams the bytes in chunkSize blocks, spinning while the ring is full.
+static void ringBulkProducerTask(void *arg)
+{
+    StreamArgs *args = static_cast<StreamArgs *>(arg);
+    uint8_t chunk[256];
+
+    memset(chunk, 0xA5, sizeof(chunk));
+    for (uint32_t sent = 0; sent < args->totalBytes;) {
+        size_t written = args->ring->write(chunk, args->chunkSize);
+
+        if (written == 0) {
+            taskYIELD();
+        }
+        sent += (uint32_t)written;
+    }
+
+    xTaskNotifyGive(args->mainTask);
+    vTaskDelete(nullptr);
+}
+
+// Sends one byte per queue item, the pattern the ring buffer replaces.
+static void queueProducerTask(void *arg)
+{
+    StreamArgs *args = static_cast<StreamArgs *>(arg);
+
+    for (uint32_t sent = 0; sent < args->totalBytes; sent++) {
+        uint8_t b = (uint8_t)sent;
+
+        xQueueSend(args->queue, &b, portMAX_DELAY);
+    }
+
+    xTaskNotifyGive(args->mainTask);
+    vTaskDelete(nullptr);
+}
+
+static void startProducer(TaskFunction_t fn, StreamArgs *args)
+{
+    BaseType_t coreId = (portNUM_PROCESSORS > 1) ? 0 : tskNO_AFFINITY;
+    BaseType_t res = xTaskCreatePinnedToCore(fn, "ring_producer", kTaskStackSize, args, kTaskPriority, nullptr, coreId);
+
+    TEST_ASSERT_EQUAL(pdPASS, res);
+}
+
+static void printThroughput(const char *name, uint32_t bytes, int64_t elapsedUs)
+{
+    printf("[bench] %-48s %8lu bytes %10lld us %10.3f MB/s\n", name, (unsigned long)bytes, (long long)elapsedUs,
+           (double)bytes / (double)(elapsedUs ? elapsedUs : 1));
+}
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd spsc_ring_buffer push pop and wrap", "lightstd spsc_ring_buffer")
+{
+    CountingAllocator alloc;
+    {
+        spsc_ring_buffer<uint16_t> ring(&alloc);
+        uint16_t out[16];
+        uint16_t v = 0;
+
+        TEST_ASSERT_FALSE(ring.push(1));
+        TEST_ASSERT_FALSE(ring.pop(v));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ring.init(0));
+        TEST_ASSERT_EQUAL(ESP_OK, ring.init(6));
+        TEST_ASSERT_EQUAL_UINT32(8, ring.capacity());
+        TEST_ASSERT_TRUE(ring.empty());
+
+        // Every slot is usable.
+        for (uint16_t i = 0; i < 8; i++) {
+            TEST_ASSERT_TRUE(ring.push(i));
+        }
+        TEST_ASSERT_FALSE(ring.push(8));
+        TEST_ASSERT_EQUAL_UINT32(0, ring.free_space());
+        TEST_ASSERT_TRUE(ring.pop(v));
+        TEST_ASSERT_EQUAL_UINT32(0, v);
+        TEST_ASSERT_EQUAL_UINT32(7, ring.read(out, 16));
+        TEST_ASSERT_EQUAL_UINT32(7, out[6]);
+        TEST_ASSERT_TRUE(ring.empty());
+
+        // Head and tail now sit at slot 0 after a full lap; move them to slot 5 so writes wrap.
+        static const uint16_t kData[] = {10, 11, 12, 13, 14, 15, 16};
+        TEST_ASSERT_EQUAL_UINT32(5, ring.write(kData, 5));
+        TEST_ASSERT_EQUAL_UINT32(5, ring.read(out, 5));
+        TEST_ASSERT_EQUAL_UINT32(7, ring.write(kData, 7));
+        TEST_ASSERT_EQUAL_UINT32(1, ring.write(kData, 7));
+        TEST_ASSERT_EQUAL_UINT32(8, ring.size());
+
+        // The read span stops at the end of the storage; the rest comes on the next call.
+        span<const uint16_t> filled = ring.read_span();
+        TEST_ASSERT_EQUAL_UINT32(3, filled.size());
+        TEST_ASSERT_EQUAL_UINT32(10, filled[0]);
+        ring.consume(filled.size());
+        filled = ring.read_span();
+        TEST_ASSERT_EQUAL_UINT32(5, filled.size());
+        TEST_ASSERT_EQUAL_UINT32(13, filled[0]);
+        TEST_ASSERT_EQUAL_UINT32(10, filled[4]);
+        ring.consume(filled.size());
+
+        // Same for the write span: the ring is empty with the tail at slot 5.
+        span<uint16_t> region = ring.write_span();
+        TEST_ASSERT_EQUAL_UINT32(3, region.size());
+        for (size_t i = 0; i < region.size(); i++) {
+            region[i] = (uint16_t)(100 + i);
+        }
+        ring.commit_write(region.size());
+        region = ring.write_span();
+        TEST_ASSERT_EQUAL_UINT32(5, region.size());
+        region[0] = 103;
+        ring.commit_write(1);
+        TEST_ASSERT_EQUAL_UINT32(4, ring.read(out, 16));
+        TEST_ASSERT_EQUAL_UINT32(100, out[0]);
+        TEST_ASSERT_EQUAL_UINT32(103, out[3]);
+
+        ring.deinit();
+        TEST_ASSERT_EQUAL_UINT32(0, ring.capacity());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd spsc_ring_buffer producer task stream", "lightstd spsc_ring_buffer")
+{
+    spsc_ring_buffer<uint8_t> ring;
+    StreamArgs args = {};
+    uint8_t buf[64];
+    uint32_t received = 0;
+    uint32_t mismatches = 0;
+    int64_t deadlineUs = esp_timer_get_time() + (int64_t)kTestTimeout * portTICK_PERIOD_MS * 1000;
+
+    TEST_ASSERT_EQUAL(ESP_OK, ring.init(256));
+    args.ring = &ring;
+    args.mainTask = xTaskGetCurrentTaskHandle();
+    args.totalBytes = 200000;
+    startProducer(ringProducerTask, &args);
+
+    // Alternate bulk reads and in-place span reads while checking the byte pattern.
+    while (received < args.totalBytes && esp_timer_get_time() < deadlineUs) {
+        if (received & 1) {
+            size_t n = ring.read(buf, sizeof(buf));
+
+            for (size_t i = 0; i < n; i++) {
+                mismatches += (buf[i] != (uint8_t)(received + i)) ? 1 : 0;
+            }
+            received += (uint32_t)n;
+            if (n == 0) {
+                taskYIELD();
+            }
+        }
+        else {
+            span<const uint8_t> filled = ring.read_span();
+
+            for (size_t i = 0; i < filled.size(); i++) {
+                mismatches += (filled[i] != (uint8_t)(received + i)) ? 1 : 0;
+            }
+            ring.consume(filled.size());
+            received += (uint32_t)filled.size();
+            if (filled.empty()) {
+                taskYIELD();
+            }
+        }
+    }
+
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, ulTaskNotifyTake(pdTRUE, kTestTimeout));
+    TEST_ASSERT_EQUAL_UINT32(args.totalBytes, received);
+    TEST_ASSERT_EQUAL_UINT32(0, mismatches);
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+TEST_CASE("lightstd spsc_ring_buffer vs queue benchmark", "lightstd spsc_ring_buffer benchmark")
+{
+    constexpr uint32_t kQueueBytes = 20000;
+    constexpr uint32_t kRingBytes = 1000000;
+    static const uint32_t kChunkSizes[] = {1, 16, 64, 256};
+    StreamArgs args = {};
+    uint8_t buf[256];
+    char label[64];
+
+    args.mainTask = xTaskGetCurrentTaskHandle();
+
+    // One byte per xQueueSend/xQueueReceive.
+    args.queue = xQueueCreate(256, 1);
+    TEST_ASSERT_NOT_NULL(args.queue);
+    args.totalBytes = kQueueBytes;
+    int64_t startUs = esp_timer_get_time();
+    startProducer(queueProducerTask, &args);
+    for (uint32_t received = 0; received < kQueueBytes; received++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xQueueReceive(args.queue, buf, kTestTimeout));
+    }
+    printThroughput("xQueueSend/xQueueReceive 1 byte items", kQueueBytes, esp_timer_get_time() - startUs);
+    TEST_ASSERT_NOT_EQUAL_UINT32(0, ulTaskNotifyTake(pdTRUE, kTestTimeout));
+    vQueueDelete(args.queue);
+    args.queue = nullptr;
+
+    // Same 256 byte buffer, written and read in chunks.
+    for (uint32_t chunkSize : kChunkSizes) {
+        spsc_ring_buffer<uint8_t> ring;
+        uint32_t received = 0;
+
+        TEST_ASSERT_EQUAL(ESP_OK, ring.init(256));
+        args.ring = &ring;
+        args.totalBytes = kRingBytes;
+        args.chunkSize = chunkSize;
+        startUs = esp_timer_get_time();
+        startProducer(ringBulkProducerTask, &args);
+        while (received < kRingBytes) {
+            size_t n = ring.read(buf, chunkSize);
+
+            if (n == 0) {
+                taskYIELD();
+            }
+            received += (uint32_t)n;
+        }
+        snprintf(label, sizeof(label), "spsc_ring_buffer %lu byte chunks", (unsigned long)chunkSize);
+        printThroughput(label, kRingBytes, esp_timer_get_time() - startUs);
+        TEST_ASSERT_NOT_EQUAL_UINT32(0, ulTaskNotifyTake(pdTRUE, kTestTimeout));
+    }
+}
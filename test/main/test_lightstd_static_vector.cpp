@@ -0,0 +1,65 @@
+#include <unity.h>
+#include "lightstd/static_vector.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+// Constant-initialized: usable before any constructor runs.
+#if __cpp_constinit
+constinit
+#endif // __cpp_constinit
+static static_vector<uint32_t, 8> bootList;
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd static_vector fixed capacity", "lightstd static_vector")
+{
+    const uint32_t src[] = {1, 2, 3, 4, 5, 6};
+
+    TEST_ASSERT_TRUE(bootList.empty());
+    TEST_ASSERT_EQUAL_UINT32(8, bootList.capacity());
+
+    TEST_ASSERT_TRUE(bootList.append(src, 6));
+    TEST_ASSERT_TRUE(bootList.push_back(7));
+    TEST_ASSERT_TRUE(bootList.emplace_back(8u));
+    TEST_ASSERT_TRUE(bootList.full());
+    TEST_ASSERT_FALSE(bootList.push_back(9));
+    TEST_ASSERT_FALSE(bootList.append(src, 1));
+    TEST_ASSERT_FALSE(bootList.resize(9));
+    TEST_ASSERT_FALSE(bootList.reserve(9));
+    TEST_ASSERT_EQUAL_UINT32(8, bootList.size());
+
+    bootList.erase(bootList.begin(), bootList.begin() + 4);
+    TEST_ASSERT_EQUAL_UINT32(4, bootList.size());
+    TEST_ASSERT_EQUAL_UINT32(5, bootList.front());
+    TEST_ASSERT_EQUAL_UINT32(8, bootList.back());
+
+    TEST_ASSERT_TRUE(bootList.insert(bootList.begin() + 1, bootList.begin() + 2, bootList.end()));
+    const uint32_t expected[] = {5, 7, 8, 6, 7, 8};
+    TEST_ASSERT_EQUAL_UINT32(6, bootList.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected, bootList.data(), sizeof(expected));
+
+    bootList.clear();
+    TEST_ASSERT_TRUE(bootList.empty());
+}
+
+TEST_CASE("lightstd static_vector move with non-trivial elements", "lightstd static_vector")
+{
+    static_vector<vector<int>, 4> a;
+    vector<int> inner;
+
+    TEST_ASSERT_TRUE(inner.push_back(10));
+    TEST_ASSERT_TRUE(a.push_back(std::move(inner)));
+    TEST_ASSERT_TRUE(a.resize(3));
+
+    static_vector<vector<int>, 4> b(std::move(a));
+    TEST_ASSERT_TRUE(a.empty());
+    TEST_ASSERT_EQUAL_UINT32(3, b.size());
+    TEST_ASSERT_EQUAL(10, b[0][0]);
+
+    b.pop_back();
+    a = std::move(b);
+    TEST_ASSERT_EQUAL_UINT32(2, a.size());
+    TEST_ASSERT_EQUAL(10, a[0][0]);
+}
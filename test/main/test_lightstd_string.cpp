@@ -1,5 +1,12 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <utility>
 #include <unity.h>
 #include "lightstd/string.h"
+#include "benchmark.h"
+#include "counting_allocator.h"
 
 using namespace lightstd;
 
@@ -22,3 +29,344 @@ TEST_CASE("lightstd string append and resize", "lightstd string")
     TEST_ASSERT_TRUE(s.empty());
     TEST_ASSERT_EQUAL_STRING("", s.c_str());
 }
+
+TEST_CASE("lightstd string short values stay inline", "lightstd string")
+{
+    CountingAllocator alloc;
+    string s(&alloc);
+
+    TEST_ASSERT_EQUAL_UINT32(string::SSO_CAPACITY, s.capacity());
+    TEST_ASSERT_TRUE(s.append("wifi.ssid"));
+    TEST_ASSERT_EQUAL_STRING("wifi.ssid", s.c_str());
+    while (s.length() < string::SSO_CAPACITY) {
+        TEST_ASSERT_TRUE(s.push_back('!'));
+    }
+    TEST_ASSERT_EQUAL_UINT32(string::SSO_CAPACITY, strlen(s.c_str()));
+    TEST_ASSERT_EQUAL_UINT32(0, alloc.allocations);
+
+    // Growing past the inline buffer moves the contents to the heap.
+    TEST_ASSERT_TRUE(s.resize(4));
+    while (s.length() <= string::SSO_CAPACITY) {
+        TEST_ASSERT_TRUE(s.append(s.c_str(), s.length()));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, alloc.allocations);
+    TEST_ASSERT_EQUAL_STRING_LEN("wifiwifiwifiwifi", s.c_str() + s.length() - 16, 16);
+
+    string moved(std::move(s));
+    TEST_ASSERT_TRUE(s.empty());
+    TEST_ASSERT_EQUAL_STRING("", s.c_str());
+    TEST_ASSERT_EQUAL_STRING_LEN("wifiwifiwifiwifi", moved.c_str(), 16);
+
+    string small(&alloc);
+    TEST_ASSERT_TRUE(small.append("qos"));
+    moved = std::move(small);
+    TEST_ASSERT_EQUAL_STRING("qos", moved.c_str());
+    TEST_ASSERT_EQUAL_UINT32(1, alloc.deallocations);
+}
+
+TEST_CASE("lightstd string geometric growth and shrink", "lightstd string")
+{
+    CountingAllocator alloc;
+    string s(&alloc);
+
+    for (size_t i = 0; i < 1000; i++) {
+        TEST_ASSERT_TRUE(s.push_back((char)('a' + (i % 26))));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1000, s.length());
+    TEST_ASSERT_EQUAL(0, memcmp(s.c_str(), "abcdefghijklmnopqrstuvwxyz", 26));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(8, alloc.allocations);
+
+    TEST_ASSERT_TRUE(s.shrink_to_fit());
+    TEST_ASSERT_EQUAL_UINT32(1000, s.capacity());
+
+    TEST_ASSERT_TRUE(s.resize(3));
+    TEST_ASSERT_TRUE(s.shrink_to_fit());
+    TEST_ASSERT_EQUAL_UINT32(string::SSO_CAPACITY, s.capacity());
+    TEST_ASSERT_EQUAL_STRING("abc", s.c_str());
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+
+    // reserve stays exact
+    TEST_ASSERT_TRUE(s.reserve(100));
+    TEST_ASSERT_EQUAL_UINT32(100, s.capacity());
+}
+
+TEST_CASE("lightstd string config load benchmark", "lightstd string benchmark")
+{
+    static const char *kConfig[][2] = {
+        {"wifi.ssid", "home-network"},
+        {"wifi.pass", "correct-horse-battery"},
+        {"mqtt.host", "10.0.0.12"},
+        {"mqtt.port", "1883"},
+        {"mqtt.user", "sensor-07"},
+        {"mqtt.topic", "home/livingroom/temp"},
+        {"dev.name", "thermo-7"},
+        {"dev.tz", "UTC-3"},
+        {"ntp.server", "pool.ntp.org"},
+        {"led.mode", "pwm"},
+        {"btn.hold_ms", "3000"},
+        {"log.level", "info"},
+    };
+    constexpr size_t kEntries = sizeof(kConfig) / sizeof(kConfig[0]);
+    constexpr uint32_t kIterations = 1000;
+    CountingAllocator alloc;
+
+    benchmarkRun("string config load (12 key/value pairs)", kIterations, [&](uint32_t) {
+        string keys[kEntries] = {};
+        string values[kEntries] = {};
+
+        for (size_t i = 0; i < kEntries; i++) {
+            keys[i] = string(&alloc);
+            values[i] = string(&alloc);
+            if ((!keys[i].append(kConfig[i][0])) || (!values[i].append(kConfig[i][1]))) {
+                TEST_FAIL();
+            }
+        }
+        benchmarkKeep(keys);
+        benchmarkKeep(values);
+    });
+
+    const size_t strings = kIterations * kEntries * 2;
+    printf("[bench] string config load: %lu strings, %lu allocations, %lu avoided\n", (unsigned long)strings,
+           (unsigned long)alloc.allocations, (unsigned long)(strings - alloc.allocations));
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd string formatting appenders", "lightstd string")
+{
+    string s;
+
+    TEST_ASSERT_TRUE(s.appendf("%s=%d", "rssi", -67));
+    TEST_ASSERT_EQUAL_STRING("rssi=-67", s.c_str());
+
+    // Output larger than the spare capacity grows the string once.
+    s.clear();
+    TEST_ASSERT_TRUE(s.appendf("%064d|%s", 7, "end"));
+    TEST_ASSERT_EQUAL_UINT32(68, s.length());
+    TEST_ASSERT_EQUAL_STRING("7|end", s.c_str() + 63);
+
+    s.clear();
+    TEST_ASSERT_TRUE(s.appendInt(0));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendInt(INT64_MIN));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendUInt(UINT64_MAX));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendUInt(4294967296ull));
+    TEST_ASSERT_EQUAL_STRING("0 -9223372036854775808 18446744073709551615 4294967296", s.c_str());
+
+    s.clear();
+    TEST_ASSERT_TRUE(s.appendHex(0x1F));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendHex(0xBEEF, 8, true));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendHex(0));
+    TEST_ASSERT_EQUAL_STRING("1f 0000BEEF 0", s.c_str());
+
+    s.clear();
+    TEST_ASSERT_TRUE(s.appendFixed(23.456, 2));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendFixed(-0.004, 2));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendFixed(-1.995, 1));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendFixed(9.96, 0));
+    TEST_ASSERT_TRUE(s.push_back(' '));
+    TEST_ASSERT_TRUE(s.appendFixed(0.5, 3));
+    TEST_ASSERT_EQUAL_STRING("23.46 0.00 -2.0 10 0.500", s.c_str());
+}
+
+TEST_CASE("lightstd string telemetry formatting benchmark", "lightstd string benchmark")
+{
+    constexpr uint32_t kIterations = 2000;
+    string line;
+
+    TEST_ASSERT_TRUE(line.reserve(128));
+
+    benchmarkRun("snprintf + append telemetry line", kIterations, [&](uint32_t i) {
+        char buf[128];
+
+        line.clear();
+        snprintf(buf, sizeof(buf), "temp=%.2f,hum=%.2f,rssi=%d,uptime=%lu,flags=0x%04x", 23.45 + (i & 7), 51.2, -67,
+                 (unsigned long)(123456 + i), (unsigned int)(i & 0xFFFF));
+        if (!line.append(buf)) {
+            TEST_FAIL();
+        }
+        benchmarkKeep(line.c_str());
+    });
+
+    benchmarkRun("appendf telemetry line", kIterations, [&](uint32_t i) {
+        line.clear();
+        if (!line.appendf("temp=%.2f,hum=%.2f,rssi=%d,uptime=%lu,flags=0x%04x", 23.45 + (i & 7), 51.2, -67,
+                          (unsigned long)(123456 + i), (unsigned int)(i & 0xFFFF))) {
+            TEST_FAIL();
+        }
+        benchmarkKeep(line.c_str());
+    });
+
+    benchmarkRun("appendInt/appendFixed telemetry line", kIterations, [&](uint32_t i) {
+        line.clear();
+        if ((!line.append("temp=")) || (!line.appendFixed(23.45 + (i & 7), 2)) ||
+            (!line.append(",hum=")) || (!line.appendFixed(51.2, 2)) ||
+            (!line.append(",rssi=")) || (!line.appendInt(-67)) ||
+            (!line.append(",uptime=")) || (!line.appendUInt(123456 + i)) ||
+            (!line.append(",flags=0x")) || (!line.appendHex(i & 0xFFFF, 4))) {
+            TEST_FAIL();
+        }
+        benchmarkKeep(line.c_str());
+    });
+}
+
+TEST_CASE("lightstd string search and compare", "lightstd string")
+{
+    string s;
+
+    TEST_ASSERT_TRUE(s.append("home/livingroom/sensor/temp"));
+    TEST_ASSERT_TRUE(s.starts_with("home/"));
+    TEST_ASSERT_FALSE(s.starts_with("office/"));
+    TEST_ASSERT_TRUE(s.ends_with("/temp"));
+    TEST_ASSERT_TRUE(s.ends_with(""));
+    TEST_ASSERT_FALSE(s.ends_with("a much longer suffix than the whole string"));
+    TEST_ASSERT_EQUAL_INT(0, s.compare("home/livingroom/sensor/temp"));
+    TEST_ASSERT_TRUE(s.compare("home/z") < 0);
+    TEST_ASSERT_TRUE(s.compare("home") > 0);
+
+    TEST_ASSERT_EQUAL_UINT32(4, s.find('/'));
+    TEST_ASSERT_EQUAL_UINT32(15, s.find('/', 5));
+    TEST_ASSERT_EQUAL_UINT32(string_view::npos, s.find('#'));
+    TEST_ASSERT_EQUAL_UINT32(string_view::npos, s.find('h', 100));
+    TEST_ASSERT_EQUAL_UINT32(22, string_view(s).rfind('/'));
+    TEST_ASSERT_EQUAL_UINT32(16, s.find("sensor"));
+    TEST_ASSERT_EQUAL_UINT32(5, s.find("li"));
+    TEST_ASSERT_EQUAL_UINT32(3, s.find("", 3));
+    TEST_ASSERT_EQUAL_UINT32(string_view::npos, s.find("sensors"));
+
+    // Long haystacks take the Horspool path; check it against a naive scan.
+    char hay[300];
+    for (size_t i = 0; i < sizeof(hay) - 1; i++) {
+        hay[i] = (char)('a' + (i * 7) % 5);
+    }
+    hay[sizeof(hay) - 1] = '\0';
+    string_view view(hay);
+    for (size_t start = 0; start + 9 < view.length(); start += 13) {
+        for (size_t n = 2; n <= 9; n++) {
+            string_view needle = view.substr(start, n);
+            const char *found = nullptr;
+
+            for (size_t i = 0; i + n <= view.length() && !found; i++) {
+                if (memcmp(hay + i, needle.data(), n) == 0) {
+                    found = hay + i;
+                }
+            }
+            TEST_ASSERT_EQUAL_UINT32((size_t)(found - hay), view.find(needle));
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(string_view::npos, view.find("abcdz"));
+}
+
+TEST_CASE("lightstd string tokenizer", "lightstd string")
+{
+    string_tokenizer topic("home//livingroom/temp", '/');
+    string_view token;
+
+    TEST_ASSERT_TRUE(topic.next(token));
+    TEST_ASSERT_TRUE(token == "home");
+    TEST_ASSERT_TRUE(topic.next(token));
+    TEST_ASSERT_TRUE(token.empty());
+    TEST_ASSERT_TRUE(topic.remaining() == "livingroom/temp");
+    TEST_ASSERT_TRUE(topic.next(token));
+    TEST_ASSERT_TRUE(token == "livingroom");
+    TEST_ASSERT_TRUE(topic.next(token));
+    TEST_ASSERT_TRUE(token == "temp");
+    TEST_ASSERT_FALSE(topic.next(token));
+
+    string_tokenizer skipping("/a//b/", '/', true);
+    TEST_ASSERT_TRUE(skipping.next(token));
+    TEST_ASSERT_TRUE(token == "a");
+    TEST_ASSERT_TRUE(skipping.next(token));
+    TEST_ASSERT_TRUE(token == "b");
+    TEST_ASSERT_FALSE(skipping.next(token));
+
+    string_tokenizer lines("Host: a\r\nAccept: */*\r\n\r\n", "\r\n");
+    TEST_ASSERT_TRUE(lines.next(token));
+    TEST_ASSERT_TRUE(token == "Host: a");
+    TEST_ASSERT_TRUE(lines.next(token));
+    TEST_ASSERT_TRUE(token == "Accept: */*");
+    TEST_ASSERT_TRUE(lines.next(token));
+    TEST_ASSERT_TRUE(token.empty());
+    TEST_ASSERT_TRUE(lines.next(token));
+    TEST_ASSERT_TRUE(token.empty());
+    TEST_ASSERT_FALSE(lines.next(token));
+
+    string_tokenizer empty("", ',');
+    TEST_ASSERT_TRUE(empty.next(token));
+    TEST_ASSERT_TRUE(token.empty());
+    TEST_ASSERT_FALSE(empty.next(token));
+}
+
+TEST_CASE("lightstd string parsing benchmark", "lightstd string benchmark")
+{
+    static const char kTopic[] = "site/building-3/floor-2/room-17/sensor/temp/state";
+    static const char kRequest[] = "GET /api/v1/status HTTP/1.1\r\n"
+                                   "Host: 192.168.4.1\r\n"
+                                   "User-Agent: esp-http-client/1.0\r\n"
+                                   "Accept: application/json\r\n"
+                                   "Connection: keep-alive\r\n"
+                                   "Content-Length: 0\r\n"
+                                   "\r\n";
+    constexpr uint32_t kIterations = 5000;
+
+    benchmarkRun("strtok MQTT topic (copy + split)", kIterations, [&](uint32_t) {
+        char copy[sizeof(kTopic)];
+        size_t levels = 0;
+
+        memcpy(copy, kTopic, sizeof(kTopic));
+        for (char *save, *part = strtok_r(copy, "/", &save); part; part = strtok_r(nullptr, "/", &save)) {
+            levels++;
+        }
+        benchmarkKeep(levels);
+    });
+
+    benchmarkRun("string_tokenizer MQTT topic", kIterations, [&](uint32_t) {
+        string_tokenizer tok(string_view(kTopic, sizeof(kTopic) - 1), '/');
+        string_view part;
+        size_t levels = 0;
+
+        while (tok.next(part)) {
+            levels++;
+        }
+        benchmarkKeep(levels);
+    });
+
+    benchmarkRun("strstr HTTP headers", kIterations, [&](uint32_t) {
+        const char *line = strstr(kRequest, "\r\n") + 2;
+        size_t contentLength = 0;
+
+        while (line[0] != '\r') {
+            const char *eol = strstr(line, "\r\n");
+
+            if (strncmp(line, "Content-Length:", 15) == 0) {
+                contentLength = (size_t)atoi(line + 15);
+            }
+            line = eol + 2;
+        }
+        benchmarkKeep(contentLength);
+    });
+
+    benchmarkRun("string_view HTTP headers", kIterations, [&](uint32_t) {
+        string_tokenizer lines(string_view(kRequest, sizeof(kRequest) - 1), "\r\n");
+        string_view line;
+        size_t contentLength = 0;
+
+        if (!lines.next(line)) {
+            TEST_FAIL();
+        }
+        while (lines.next(line) && !line.empty()) {
+            size_t colon = line.find(':');
+
+            if (colon != string_view::npos && line.substr(0, colon) == "Content-Length") {
+                contentLength = (size_t)atoi(line.data() + colon + 1);
+            }
+        }
+        benchmarkKeep(contentLength);
+    });
+}
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "lightstd/string_pool.h"
+#include "counting_allocator.h"
+
+using namespace lightstd;
+
+// -----------------------------------------------------------------------------
+
+TEST_CASE("lightstd string_pool interns each value once", "lightstd string_pool")
+{
+    string_pool pool;
+
+    string_pool::handle_t a = pool.intern("home/livingroom/temp");
+    string_pool::handle_t b = pool.intern("home/kitchen/temp");
+    TEST_ASSERT_NOT_EQUAL(string_pool::INVALID_HANDLE, a);
+    TEST_ASSERT_NOT_EQUAL(a, b);
+
+    // Lookups by a non-terminated sub-range resolve to the same handle.
+    const char *raw = "home/livingroom/temp/extra";
+    TEST_ASSERT_EQUAL(a, pool.intern(string_view(raw, 20)));
+    TEST_ASSERT_EQUAL(a, pool.find("home/livingroom/temp"));
+    TEST_ASSERT_EQUAL(string_pool::INVALID_HANDLE, pool.find("home/garage/temp"));
+    TEST_ASSERT_EQUAL_UINT32(2, pool.size());
+
+    TEST_ASSERT_EQUAL_STRING("home/kitchen/temp", pool.c_str(b));
+    TEST_ASSERT_EQUAL_UINT32(17, pool.length(b));
+    TEST_ASSERT_TRUE(pool.view(b) == "home/kitchen/temp");
+
+    string_pool::handle_t empty = pool.intern("");
+    TEST_ASSERT_NOT_EQUAL(string_pool::INVALID_HANDLE, empty);
+    TEST_ASSERT_EQUAL_STRING("", pool.c_str(empty));
+
+    pool.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, pool.size());
+    TEST_ASSERT_EQUAL(string_pool::INVALID_HANDLE, pool.find("home/kitchen/temp"));
+}
+
+TEST_CASE("lightstd string_pool keeps pointers stable while growing", "lightstd string_pool")
+{
+    CountingAllocator alloc;
+    constexpr size_t kCount = 300;
+    // Static: together they do not fit on the main task stack.
+    static string_pool::handle_t handles[kCount];
+    static const char *pointers[kCount];
+
+    {
+        string_pool pool(&alloc, 64);
+        char key[32];
+
+        for (size_t i = 0; i < kCount; i++) {
+            snprintf(key, sizeof(key), "nvs.key.%u", (unsigned int)i);
+            handles[i] = pool.intern(key);
+            TEST_ASSERT_NOT_EQUAL(string_pool::INVALID_HANDLE, handles[i]);
+            pointers[i] = pool.c_str(handles[i]);
+        }
+
+        // A value longer than the chunk size gets its own chunk.
+        char longValue[100];
+        memset(longValue, 'x', sizeof(longValue) - 1);
+        longValue[sizeof(longValue) - 1] = '\0';
+        string_pool::handle_t longHandle = pool.intern(longValue);
+        TEST_ASSERT_EQUAL_STRING(longValue, pool.c_str(longHandle));
+
+        for (size_t i = 0; i < kCount; i++) {
+            snprintf(key, sizeof(key), "nvs.key.%u", (unsigned int)i);
+            TEST_ASSERT_EQUAL(handles[i], pool.intern(key));
+            TEST_ASSERT_EQUAL_PTR(pointers[i], pool.c_str(handles[i]));
+            TEST_ASSERT_EQUAL_STRING(key, pointers[i]);
+        }
+        TEST_ASSERT_EQUAL_UINT32(kCount + 1, pool.size());
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
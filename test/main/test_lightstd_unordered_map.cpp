@@ -1,5 +1,11 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <utility>
 #include <unity.h>
+#include "lightstd/string.h"
 #include "lightstd/unordered_map.h"
+#include "benchmark.h"
+#include "counting_allocator.h"
 
 using namespace lightstd;
 
@@ -13,6 +19,15 @@ struct ConstantHash
     }
 };
 
+// Sends keys to a handful of home slots so probe runs wrap around the end of the table.
+struct ModuloHash
+{
+    uint32_t operator()(const int& key) const
+    {
+        return (uint32_t)(key % 5) * 3 + 5;
+    }
+};
+
 // -----------------------------------------------------------------------------
 
 TEST_CASE("lightstd static_hash_map insert update erase", "lightstd unordered_map")
@@ -80,3 +95,736 @@ TEST_CASE("lightstd static_hash_map const iterator and empty begin", "lightstd u
 
     map.done();
 }
+
+TEST_CASE("lightstd static_hash_map stats", "lightstd unordered_map")
+{
+    static_hash_map<int, int, ConstantHash> map;
+    static_hash_map<int, int, ConstantHash>::stats_t st = map.stats();
+
+    TEST_ASSERT_EQUAL_UINT32(0, st.capacity);
+    TEST_ASSERT_EQUAL_UINT32(0, st.maxProbeLength);
+
+    // Every key hashes to slot 1, so the entries form a single run of probe lengths 1, 2, 3 and 4.
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(8));
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_NOT_NULL(map.insert(i, i));
+    }
+    TEST_ASSERT_TRUE(map.erase(3));
+    TEST_ASSERT_NOT_NULL(map.find(2));
+
+    st = map.stats();
+    TEST_ASSERT_EQUAL_UINT32(3, st.size);
+    TEST_ASSERT_EQUAL_UINT32(8, st.capacity);
+    TEST_ASSERT_EQUAL_UINT32(1, st.tombstones);
+    TEST_ASSERT_EQUAL_FLOAT(0.375f, st.loadFactor);
+    TEST_ASSERT_EQUAL_FLOAT(0.125f, st.tombstoneRatio);
+    TEST_ASSERT_EQUAL_UINT32(3, st.maxProbeLength);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, st.avgProbeLength);
+    TEST_ASSERT_EQUAL_UINT32(8 * map.bytes_per_slot, st.bytesUsed);
+    if (LIGHTSTD_HASH_MAP_PROBE_STATS) {
+        // 4 inserts probing 1+2+3+4 slots, the erase probing 4 and the find probing 3.
+        TEST_ASSERT_EQUAL_UINT32(6, st.lookups);
+        TEST_ASSERT_EQUAL_UINT32(17, st.probes);
+    }
+    else {
+        TEST_ASSERT_EQUAL_UINT32(0, st.lookups);
+        TEST_ASSERT_EQUAL_UINT32(0, st.probes);
+    }
+
+    map.reset_probe_stats();
+    TEST_ASSERT_EQUAL_UINT32(0, map.stats().lookups);
+}
+
+TEST_CASE("lightstd hash_map grows on demand", "lightstd unordered_map")
+{
+    CountingAllocator alloc;
+    {
+        hash_map<int, int> map(&alloc);
+
+        TEST_ASSERT_TRUE(map.empty());
+        TEST_ASSERT_NULL(map.find(1));
+        TEST_ASSERT_FALSE(map.erase(1));
+        TEST_ASSERT_EQUAL_UINT32(0, map.capacity());
+        TEST_ASSERT_EQUAL_UINT32(0, alloc.allocations);
+
+        for (int i = 0; i < 1000; i++) {
+            bool inserted = false;
+
+            TEST_ASSERT_NOT_NULL(map.insert(i, i * 10, &inserted));
+            TEST_ASSERT_TRUE(inserted);
+        }
+        TEST_ASSERT_EQUAL_UINT32(1000, map.size());
+        TEST_ASSERT_EQUAL_UINT32(2048, map.capacity());
+        for (int i = 0; i < 1000; i++) {
+            TEST_ASSERT_EQUAL(i * 10, *map.find(i));
+        }
+
+        // Updating an existing key never grows the table.
+        size_t allocations = alloc.allocations;
+        bool inserted = true;
+        TEST_ASSERT_EQUAL(-1, *map.insert(500, -1, &inserted));
+        TEST_ASSERT_FALSE(inserted);
+        TEST_ASSERT_EQUAL_UINT32(allocations, alloc.allocations);
+
+        // Re-inserting a value that lives in the table across a resize.
+        hash_map<int, int> small(&alloc);
+        TEST_ASSERT_TRUE(small.reserve(6));
+        TEST_ASSERT_EQUAL_UINT32(8, small.capacity());
+        for (int i = 0; i < 6; i++) {
+            TEST_ASSERT_NOT_NULL(small.insert(i, 100 + i));
+        }
+        TEST_ASSERT_NOT_NULL(small.insert(6, *small.find(3)));
+        TEST_ASSERT_EQUAL_UINT32(16, small.capacity());
+        TEST_ASSERT_EQUAL(103, *small.find(6));
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd hash_map load factor", "lightstd unordered_map")
+{
+    hash_map<int, int> dense(nullptr, 95);
+    hash_map<int, int> sparse(nullptr, 50);
+
+    for (int i = 0; i < 60; i++) {
+        TEST_ASSERT_NOT_NULL(dense.insert(i, i));
+        TEST_ASSERT_NOT_NULL(sparse.insert(i, i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(64, dense.capacity());
+    TEST_ASSERT_EQUAL_UINT32(128, sparse.capacity());
+}
+
+TEST_CASE("lightstd hash_map erase keeps probe runs intact", "lightstd unordered_map")
+{
+    hash_map<int, int, ModuloHash> map;
+    bool present[40] = {};
+    uint32_t seed = 12345;
+
+    // With 40 keys over 5 home slots every run collides and wraps, which exercises the backward shift.
+    for (int round = 0; round < 4000; round++) {
+        seed = seed * 1664525u + 1013904223u;
+
+        int key = (int)((seed >> 8) % 40);
+        if ((seed >> 4) & 1) {
+            TEST_ASSERT_NOT_NULL(map.insert(key, key * 2));
+            present[key] = true;
+        }
+        else {
+            TEST_ASSERT_EQUAL(present[key], map.erase(key));
+            present[key] = false;
+        }
+
+        size_t expected = 0;
+        for (int k = 0; k < 40; k++) {
+            const int *value = map.find(k);
+
+            TEST_ASSERT_EQUAL(present[k], value != nullptr);
+            if (value) {
+                TEST_ASSERT_EQUAL(k * 2, *value);
+                expected++;
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT32(expected, map.size());
+    }
+
+    size_t iterated = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        TEST_ASSERT_TRUE(present[(*it).key]);
+        iterated++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(map.size(), iterated);
+}
+
+TEST_CASE("lightstd hash_map non-trivial values", "lightstd unordered_map")
+{
+    CountingAllocator alloc;
+    {
+        hash_map<int, string> map(&alloc);
+        string value(&alloc);
+
+        // Long enough to live on the heap, so leaks and double frees show up in the counters.
+        TEST_ASSERT_TRUE(value.append("a value that does not fit in the inline buffer of lightstd::string"));
+        for (int i = 0; i < 100; i++) {
+            string copy(&alloc);
+
+            TEST_ASSERT_TRUE(copy.append(value.c_str()));
+            TEST_ASSERT_NOT_NULL(map.insert(i, std::move(copy)));
+        }
+        for (int i = 0; i < 100; i += 2) {
+            TEST_ASSERT_TRUE(map.erase(i));
+        }
+        for (int i = 1; i < 100; i += 2) {
+            TEST_ASSERT_EQUAL_STRING(value.c_str(), map.find(i)->c_str());
+        }
+        map.clear();
+        TEST_ASSERT_TRUE(map.empty());
+        TEST_ASSERT_NOT_NULL(map.insert(1, std::move(value)));
+        TEST_ASSERT_TRUE(value.empty());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd static_robin_hood_map insert update erase", "lightstd unordered_map")
+{
+    static_robin_hood_map<int, int, ConstantHash> map;
+
+    TEST_ASSERT_NULL(map.find(1));
+    TEST_ASSERT_NULL(map.insert(1, 1));
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(4));
+
+    bool inserted = false;
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_NOT_NULL(map.insert(i, i * 100, &inserted));
+        TEST_ASSERT_TRUE(inserted);
+    }
+    TEST_ASSERT_NULL(map.insert(4, 400, &inserted));
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_EQUAL(111, *map.insert(1, 111, &inserted));
+    TEST_ASSERT_FALSE(inserted);
+
+    TEST_ASSERT_TRUE(map.erase(0));
+    TEST_ASSERT_FALSE(map.erase(0));
+    TEST_ASSERT_EQUAL_UINT32(3, map.size());
+    TEST_ASSERT_EQUAL(111, *map.find(1));
+    TEST_ASSERT_EQUAL(200, *map.find(2));
+    TEST_ASSERT_EQUAL(300, *map.find(3));
+
+    int sum = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        sum += (*it).value;
+    }
+    TEST_ASSERT_EQUAL(611, sum);
+
+    map.clear();
+    TEST_ASSERT_TRUE(map.empty());
+    TEST_ASSERT_FALSE(map.contains(1));
+    map.done();
+}
+
+TEST_CASE("lightstd static_robin_hood_map randomized churn", "lightstd unordered_map")
+{
+    static_robin_hood_map<int, int, ModuloHash> map;
+    bool present[40] = {};
+    uint32_t seed = 777;
+
+    // 17 slots so that every probe run wraps around the end of the table.
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(17));
+    for (int round = 0; round < 4000; round++) {
+        seed = seed * 1664525u + 1013904223u;
+
+        int key = (int)((seed >> 8) % 40);
+        if ((seed >> 4) & 1) {
+            const bool fits = present[key] || map.size() < 17;
+            int *value = map.insert(key, key * 3);
+
+            TEST_ASSERT_EQUAL(fits, value != nullptr);
+            if (value) {
+                present[key] = true;
+            }
+        }
+        else {
+            TEST_ASSERT_EQUAL(present[key], map.erase(key));
+            present[key] = false;
+        }
+
+        size_t expected = 0;
+        for (int k = 0; k < 40; k++) {
+            const int *value = map.find(k);
+
+            TEST_ASSERT_EQUAL(present[k], value != nullptr);
+            if (value) {
+                TEST_ASSERT_EQUAL(k * 3, *value);
+                expected++;
+            }
+        }
+        TEST_ASSERT_EQUAL_UINT32(expected, map.size());
+    }
+}
+
+// Key type that counts equality checks so benchmarks can report probe lengths.
+static size_t keyCompares = 0;
+
+struct ProbeKey
+{
+    uint32_t id;
+
+    bool operator==(const ProbeKey& other) const
+    {
+        keyCompares++;
+        return id == other.id;
+    }
+};
+
+struct ProbeKeyHash
+{
+    uint32_t operator()(const ProbeKey& key) const
+    {
+        return fnv1a32(&key.id, sizeof(key.id));
+    }
+};
+
+template <class Map>
+static void benchmarkProbing(const char *name, size_t loadPercent)
+{
+    constexpr size_t kTableSize = 1024;
+    constexpr uint32_t kLookups = 5000;
+    const size_t entries = kTableSize * loadPercent / 100;
+    static uint32_t keys[kTableSize]; // too large for the main task stack
+    uint32_t nextId = 1;
+    uint32_t seed = 42;
+    Map map;
+    char label[64];
+
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(kTableSize));
+    for (size_t i = 0; i < entries; i++) {
+        keys[i] = nextId++;
+        TEST_ASSERT_NOT_NULL(map.insert(ProbeKey{keys[i]}, keys[i]));
+    }
+
+    // Churn: replace every key four times over.
+    for (size_t i = 0; i < entries * 4; i++) {
+        seed = seed * 1664525u + 1013904223u;
+
+        size_t slot = (seed >> 8) % entries;
+        TEST_ASSERT_TRUE(map.erase(ProbeKey{keys[slot]}));
+        keys[slot] = nextId++;
+        TEST_ASSERT_NOT_NULL(map.insert(ProbeKey{keys[slot]}, keys[slot]));
+    }
+
+    // Probe lengths, measured as key comparisons per lookup.
+    size_t maxCompares = 0;
+    keyCompares = 0;
+    for (size_t i = 0; i < entries; i++) {
+        size_t before = keyCompares;
+
+        TEST_ASSERT_NOT_NULL(map.find(ProbeKey{keys[i]}));
+        if (keyCompares - before > maxCompares) {
+            maxCompares = keyCompares - before;
+        }
+    }
+    size_t hitCompares = keyCompares;
+    keyCompares = 0;
+    for (size_t i = 0; i < entries; i++) {
+        TEST_ASSERT_NULL(map.find(ProbeKey{nextId + (uint32_t)i}));
+    }
+    printf("[bench] %s %u%% load: hit avg %.2f max %lu compares, miss avg %.2f compares\n", name, (unsigned)loadPercent,
+           (double)hitCompares / (double)entries, (unsigned long)maxCompares, (double)keyCompares / (double)entries);
+
+    snprintf(label, sizeof(label), "%s %u%% hit lookup", name, (unsigned)loadPercent);
+    benchmarkRun(label, kLookups, [&](uint32_t i) {
+        benchmarkKeep(map.find(ProbeKey{keys[i % entries]}));
+    });
+    snprintf(label, sizeof(label), "%s %u%% miss lookup", name, (unsigned)loadPercent);
+    benchmarkRun(label, kLookups, [&](uint32_t i) {
+        benchmarkKeep(map.find(ProbeKey{nextId + i}));
+    });
+}
+
+TEST_CASE("lightstd unordered_map probing benchmark", "lightstd unordered_map benchmark")
+{
+    static const size_t kLoads[] = {50, 75, 90};
+
+    for (size_t load : kLoads) {
+        benchmarkProbing<static_hash_map<ProbeKey, uint32_t, ProbeKeyHash>>("linear", load);
+        benchmarkProbing<static_robin_hood_map<ProbeKey, uint32_t, ProbeKeyHash>>("robin hood", load);
+    }
+}
+
+// 64-byte payload used to compare slot layouts.
+struct Payload64
+{
+    uint32_t words[16];
+};
+
+TEST_CASE("lightstd static_hash_map split layout", "lightstd unordered_map")
+{
+    static_hash_map<uint32_t, Payload64, static_hash_map_default_hash<uint32_t>, hash_map_layout_split> map;
+    bool present[64] = {};
+    uint32_t seed = 99;
+
+    TEST_ASSERT_EQUAL_UINT32(1 + sizeof(uint32_t) + sizeof(Payload64), map.bytes_per_slot);
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(48));
+    for (int round = 0; round < 3000; round++) {
+        seed = seed * 1664525u + 1013904223u;
+
+        uint32_t key = (seed >> 8) % 64;
+        if ((seed >> 4) & 1) {
+            Payload64 payload;
+
+            for (size_t i = 0; i < 16; i++) {
+                payload.words[i] = key * 16 + (uint32_t)i;
+            }
+            if (map.insert(key, payload)) {
+                present[key] = true;
+            }
+        }
+        else {
+            TEST_ASSERT_EQUAL(present[key], map.erase(key));
+            present[key] = false;
+        }
+    }
+    map.compact();
+
+    size_t expected = 0;
+    for (uint32_t k = 0; k < 64; k++) {
+        Payload64 *payload = map.find(k);
+
+        TEST_ASSERT_EQUAL(present[k], payload != nullptr);
+        if (payload) {
+            TEST_ASSERT_EQUAL_UINT32(k * 16 + 15, payload->words[15]);
+            expected++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected, map.size());
+
+    size_t iterated = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        TEST_ASSERT_EQUAL_UINT32((*it).key * 16, (*it).value.words[0]);
+        iterated++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(expected, iterated);
+}
+
+template <class Map>
+static void benchmarkLayout(const char *name)
+{
+    constexpr size_t kTableSize = 512;
+    constexpr size_t kEntries = kTableSize * 3 / 4;
+    constexpr uint32_t kLookups = 20000;
+    Map map;
+    Payload64 payload = {};
+    char label[64];
+
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(kTableSize));
+    for (uint32_t i = 0; i < kEntries; i++) {
+        payload.words[0] = i;
+        TEST_ASSERT_NOT_NULL(map.insert(i * 2654435761u, payload));
+    }
+    printf("[bench] %s layout: %lu bytes per slot, %lu bytes table\n", name, (unsigned long)Map::bytes_per_slot,
+           (unsigned long)(Map::bytes_per_slot * kTableSize));
+
+    snprintf(label, sizeof(label), "%s layout hit lookup", name);
+    benchmarkRun(label, kLookups, [&](uint32_t i) {
+        benchmarkKeep(map.find((i % kEntries) * 2654435761u));
+    });
+    snprintf(label, sizeof(label), "%s layout miss lookup", name);
+    benchmarkRun(label, kLookups, [&](uint32_t i) {
+        benchmarkKeep(map.find(i * 2654435761u + 1));
+    });
+}
+
+TEST_CASE("lightstd static_hash_map layout benchmark", "lightstd unordered_map benchmark")
+{
+    benchmarkLayout<static_hash_map<uint32_t, Payload64>>("interleaved");
+    benchmarkLayout<static_hash_map<uint32_t, Payload64, static_hash_map_default_hash<uint32_t>, hash_map_layout_split>>("split");
+}
+
+TEST_CASE("lightstd hash_map string keys and transparent lookup", "lightstd unordered_map")
+{
+    static const char *kNames[] = {"wifi", "mqtt", "ota", "a sensor name long enough to be stored on the heap"};
+    CountingAllocator alloc;
+    {
+        hash_map<string, int> registry(&alloc);
+
+        for (int i = 0; i < 4; i++) {
+            string name(&alloc);
+
+            TEST_ASSERT_TRUE(name.append(kNames[i]));
+            TEST_ASSERT_NOT_NULL(registry.insert(std::move(name), i));
+        }
+
+        // Lookups by C string, view or string never build a temporary key.
+        size_t allocations = alloc.allocations;
+        char buffer[8] = "mqtt";
+        TEST_ASSERT_EQUAL(1, *registry.find(buffer));
+        TEST_ASSERT_EQUAL(2, *registry.find("ota"));
+        TEST_ASSERT_EQUAL(3, *registry.find(string_view(kNames[3])));
+        TEST_ASSERT_TRUE(registry.contains(string_view("wifi-extra", 4)));
+        TEST_ASSERT_FALSE(registry.contains("wif"));
+        TEST_ASSERT_NULL(registry.find(""));
+        TEST_ASSERT_EQUAL_UINT32(allocations, alloc.allocations);
+
+        // Re-inserting an existing key keeps the stored one and updates the value.
+        string again(&alloc);
+        bool inserted = true;
+        TEST_ASSERT_TRUE(again.append("wifi"));
+        TEST_ASSERT_EQUAL(10, *registry.insert(std::move(again), 10, &inserted));
+        TEST_ASSERT_FALSE(inserted);
+
+        TEST_ASSERT_TRUE(registry.erase("ota"));
+        TEST_ASSERT_FALSE(registry.contains("ota"));
+        TEST_ASSERT_EQUAL_UINT32(3, registry.size());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd static maps compare C string keys by content", "lightstd unordered_map")
+{
+    static_hash_map<const char*, int> byName;
+    static_robin_hood_map<string_view, int> byView;
+    char key[8] = "led";
+
+    TEST_ASSERT_EQUAL(ESP_OK, byName.init(8));
+    TEST_ASSERT_NOT_NULL(byName.insert("led", 1));
+    TEST_ASSERT_NOT_NULL(byName.insert("button", 2));
+    TEST_ASSERT_EQUAL(1, *byName.find(key));
+    TEST_ASSERT_EQUAL(2, *byName.find(string_view("button")));
+    TEST_ASSERT_TRUE(byName.erase(key));
+    TEST_ASSERT_FALSE(byName.contains("led"));
+
+    TEST_ASSERT_EQUAL(ESP_OK, byView.init(8));
+    TEST_ASSERT_NOT_NULL(byView.insert(string_view("relay-1"), 7));
+    TEST_ASSERT_EQUAL(7, *byView.find("relay-1"));
+    TEST_ASSERT_NULL(byView.find("relay"));
+}
+
+// Tracks live instances to catch leaked or doubly destroyed entries.
+static int liveTracked = 0;
+
+struct Tracked
+{
+    int value;
+
+    explicit Tracked(int v = 0) noexcept : value(v)
+    {
+        liveTracked++;
+    }
+    Tracked(const Tracked& other) noexcept : value(other.value)
+    {
+        liveTracked++;
+    }
+    Tracked(Tracked&& other) noexcept : value(other.value)
+    {
+        other.value = -1;
+        liveTracked++;
+    }
+    ~Tracked()
+    {
+        liveTracked--;
+    }
+    Tracked& operator=(const Tracked&) noexcept = default;
+    Tracked& operator=(Tracked&&) noexcept = default;
+};
+
+template <class Layout>
+static void checkNonTrivialValues()
+{
+    CountingAllocator alloc;
+    {
+        static_hash_map<string, string, static_hash_map_default_hash<string>, Layout> map;
+        bool inserted = false;
+
+        TEST_ASSERT_EQUAL(ESP_OK, map.init(32));
+        for (int i = 0; i < 24; i++) {
+            string key(&alloc);
+            string value(&alloc);
+
+            TEST_ASSERT_TRUE(key.appendf("a key long enough to need heap storage #%d", i));
+            TEST_ASSERT_TRUE(value.appendf("and an even longer value, also stored on the heap #%d", i));
+            TEST_ASSERT_NOT_NULL(map.insert(std::move(key), std::move(value), &inserted));
+            TEST_ASSERT_TRUE(inserted);
+        }
+
+        // Erasing most entries triggers the tombstone rebuild, which has to move the survivors.
+        for (int i = 0; i < 20; i++) {
+            char key[64];
+
+            snprintf(key, sizeof(key), "a key long enough to need heap storage #%d", i);
+            TEST_ASSERT_TRUE(map.erase(key));
+        }
+        TEST_ASSERT_EQUAL_UINT32(4, map.size());
+        TEST_ASSERT_EQUAL_STRING("and an even longer value, also stored on the heap #23",
+                                 map.find("a key long enough to need heap storage #23")->c_str());
+
+        // try_emplace keeps an existing value, emplace replaces it.
+        string key(&alloc);
+        TEST_ASSERT_TRUE(key.append("a key long enough to need heap storage #22"));
+        auto res = map.try_emplace(std::move(key), &alloc);
+        TEST_ASSERT_NOT_NULL(res.value);
+        TEST_ASSERT_FALSE(res.inserted);
+        TEST_ASSERT_FALSE(res.value->empty());
+
+        string other(&alloc);
+        TEST_ASSERT_TRUE(other.append("new"));
+        res = map.emplace(std::move(other), &alloc);
+        TEST_ASSERT_TRUE(res.inserted);
+        TEST_ASSERT_TRUE(res.value->empty());
+        TEST_ASSERT_EQUAL_UINT32(5, map.size());
+    }
+    TEST_ASSERT_EQUAL_UINT32(alloc.allocations, alloc.deallocations);
+}
+
+TEST_CASE("lightstd static_hash_map non-trivial keys and values", "lightstd unordered_map")
+{
+    checkNonTrivialValues<hash_map_layout_interleaved>();
+    checkNonTrivialValues<hash_map_layout_split>();
+}
+
+TEST_CASE("lightstd static_hash_map emplace lifetimes", "lightstd unordered_map")
+{
+    {
+        static_hash_map<int, Tracked> map;
+
+        TEST_ASSERT_EQUAL(ESP_OK, map.init(16));
+        for (int i = 0; i < 12; i++) {
+            auto res = map.try_emplace(i, i * 10);
+
+            TEST_ASSERT_TRUE(res.inserted);
+            TEST_ASSERT_EQUAL(i * 10, res.value->value);
+        }
+        TEST_ASSERT_EQUAL(12, liveTracked);
+
+        auto res = map.try_emplace(3, 999);
+        TEST_ASSERT_FALSE(res.inserted);
+        TEST_ASSERT_EQUAL(30, res.value->value);
+
+        res = map.emplace(3, 333);
+        TEST_ASSERT_FALSE(res.inserted);
+        TEST_ASSERT_EQUAL(333, res.value->value);
+        TEST_ASSERT_EQUAL(12, liveTracked);
+
+        for (int i = 0; i < 10; i++) {
+            TEST_ASSERT_TRUE(map.erase(i));
+        }
+        TEST_ASSERT_EQUAL(2, liveTracked);
+        map.compact();
+        TEST_ASSERT_EQUAL(2, liveTracked);
+        TEST_ASSERT_EQUAL(110, map.find(11)->value);
+
+        // A full table reports failure without constructing anything.
+        for (int i = 100; i < 114; i++) {
+            TEST_ASSERT_NOT_NULL(map.insert(i, Tracked(i)));
+        }
+        res = map.try_emplace(200, 200);
+        TEST_ASSERT_NULL(res.value);
+        TEST_ASSERT_EQUAL(16, liveTracked);
+
+        map.clear();
+        TEST_ASSERT_EQUAL(0, liveTracked);
+        TEST_ASSERT_TRUE(map.try_emplace(1, 1).inserted);
+    }
+    TEST_ASSERT_EQUAL(0, liveTracked);
+}
+
+// Uses key / 10 as the home slot so tests can lay out probe runs by hand.
+struct TensHash
+{
+    uint32_t operator()(const int& key) const
+    {
+        return (uint32_t)(key / 10);
+    }
+};
+
+TEST_CASE("lightstd static_hash_map purges tombstones in wrapped runs", "lightstd unordered_map")
+{
+    static_hash_map<int, Tracked, TensHash> map;
+
+    // Builds 0:30 1:0 2:tombstone 3:11, where every probe run crosses the end of the table or a tombstone
+    // and no slot is empty, then purges the tombstone.
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(4));
+    TEST_ASSERT_NOT_NULL(map.insert(10, Tracked(10)));
+    TEST_ASSERT_NOT_NULL(map.insert(20, Tracked(20)));
+    TEST_ASSERT_NOT_NULL(map.insert(11, Tracked(11)));
+    TEST_ASSERT_NOT_NULL(map.insert(30, Tracked(30)));
+    TEST_ASSERT_TRUE(map.erase(10));
+    TEST_ASSERT_NOT_NULL(map.insert(0, Tracked(0)));
+    TEST_ASSERT_TRUE(map.erase(20));
+    TEST_ASSERT_EQUAL_UINT32(1, map.stats().tombstones);
+
+    map.compact();
+    TEST_ASSERT_EQUAL_UINT32(0, map.stats().tombstones);
+    TEST_ASSERT_EQUAL(3, liveTracked);
+    TEST_ASSERT_EQUAL(0, map.find(0)->value);
+    TEST_ASSERT_EQUAL(11, map.find(11)->value);
+    TEST_ASSERT_EQUAL(30, map.find(30)->value);
+    TEST_ASSERT_NULL(map.find(10));
+
+    map.deinit();
+    TEST_ASSERT_EQUAL(0, liveTracked);
+}
+
+TEST_CASE("lightstd static_hash_map randomized churn", "lightstd unordered_map")
+{
+    static const size_t kTableSizes[] = {7, 16, 31};
+
+    for (size_t tableSize : kTableSizes) {
+        static_hash_map<int, Tracked, ModuloHash> map;
+        bool present[64] = {};
+        uint32_t seed = 4242 + (uint32_t)tableSize;
+
+        TEST_ASSERT_EQUAL(ESP_OK, map.init(tableSize));
+        for (int round = 0; round < 6000; round++) {
+            seed = seed * 1664525u + 1013904223u;
+
+            int key = (int)((seed >> 8) % 64);
+            switch ((seed >> 4) % 8) {
+                case 0:
+                    map.compact();
+                    break;
+                case 1:
+                case 2:
+                case 3:
+                case 4: {
+                    const bool fits = present[key] || map.size() < tableSize;
+                    Tracked *value = map.insert(key, Tracked(key * 3));
+
+                    TEST_ASSERT_EQUAL(fits, value != nullptr);
+                    if (value) {
+                        present[key] = true;
+                    }
+                    break;
+                }
+                default:
+                    TEST_ASSERT_EQUAL(present[key], map.erase(key));
+                    present[key] = false;
+                    break;
+            }
+
+            size_t expected = 0;
+            for (int k = 0; k < 64; k++) {
+                const Tracked *value = map.find(k);
+
+                TEST_ASSERT_EQUAL(present[k], value != nullptr);
+                if (value) {
+                    TEST_ASSERT_EQUAL(k * 3, value->value);
+                    expected++;
+                }
+            }
+            TEST_ASSERT_EQUAL_UINT32(expected, map.size());
+            TEST_ASSERT_EQUAL((int)expected, liveTracked);
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(tableSize / 4, map.stats().tombstones);
+        }
+    }
+    TEST_ASSERT_EQUAL(0, liveTracked);
+}
+
+template <class Map>
+static void benchmarkEraseHeavy(const char *name)
+{
+    constexpr size_t kTableSize = 512;
+    constexpr uint32_t kLive = kTableSize * 3 / 4;
+    constexpr uint32_t kRounds = 20000;
+    Map map;
+    char label[64];
+
+    // Sliding window: every round erases the oldest key and inserts a new one, so the map keeps a steady
+    // 75% load while tombstones pile up and get purged.
+    TEST_ASSERT_EQUAL(ESP_OK, map.init(kTableSize));
+    for (uint32_t i = 0; i < kLive; i++) {
+        TEST_ASSERT_NOT_NULL(map.insert(i * 2654435761u, i));
+    }
+    snprintf(label, sizeof(label), "%s sliding window erase+insert", name);
+    benchmarkRun(label, kRounds, [&](uint32_t i) {
+        benchmarkKeep(map.erase(i * 2654435761u));
+        benchmarkKeep(map.insert((i + kLive) * 2654435761u, i));
+    });
+    snprintf(label, sizeof(label), "%s lookup after churn", name);
+    benchmarkRun(label, kRounds, [&](uint32_t i) {
+        benchmarkKeep(map.find((kRounds + (i % kLive)) * 2654435761u));
+    });
+}
+
+TEST_CASE("lightstd static_hash_map erase-heavy benchmark", "lightstd unordered_map benchmark")
+{
+    benchmarkEraseHeavy<static_hash_map<uint32_t, uint32_t>>("static_hash_map");
+    benchmarkEraseHeavy<static_robin_hood_map<uint32_t, uint32_t>>("static_robin_hood_map");
+}
@@ -1,5 +1,8 @@
+#include <stdint.h>
+#include <string.h>
 #include <unity.h>
 #include "lightstd/vector.h"
+#include "benchmark.h"
 
 using namespace lightstd;
 
@@ -31,3 +34,125 @@ TEST_CASE("lightstd vector resize and shrink", "lightstd vector")
     TEST_ASSERT_TRUE(v.shrink_to_fit());
     TEST_ASSERT_EQUAL_UINT32(v.size(), v.capacity());
 }
+
+TEST_CASE("lightstd vector bulk append insert and erase", "lightstd vector")
+{
+    const int src[] = {1, 2, 3, 4, 5};
+    vector<int> v;
+
+    TEST_ASSERT_TRUE(v.append(src, 5));
+    TEST_ASSERT_EQUAL_UINT32(5, v.size());
+
+    TEST_ASSERT_TRUE(v.insert(v.begin() + 1, src + 3, src + 5));
+    TEST_ASSERT_EQUAL_UINT32(7, v.size());
+    const int expected1[] = {1, 4, 5, 2, 3, 4, 5};
+    TEST_ASSERT_EQUAL_MEMORY(expected1, v.data(), sizeof(expected1));
+
+    // Self-referencing insert must see the original values.
+    TEST_ASSERT_TRUE(v.insert(v.begin() + 2, v.begin(), v.begin() + 4));
+    const int expected2[] = {1, 4, 1, 4, 5, 2, 5, 2, 3, 4, 5};
+    TEST_ASSERT_EQUAL_UINT32(11, v.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected2, v.data(), sizeof(expected2));
+
+    int *next = v.erase(v.begin() + 1, v.begin() + 8);
+    TEST_ASSERT_EQUAL_PTR(v.begin() + 1, next);
+    const int expected3[] = {1, 3, 4, 5};
+    TEST_ASSERT_EQUAL_UINT32(4, v.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected3, v.data(), sizeof(expected3));
+
+    TEST_ASSERT_TRUE(v.append(v.data(), v.size()));
+    TEST_ASSERT_EQUAL_UINT32(8, v.size());
+    TEST_ASSERT_EQUAL(5, v[7]);
+
+    TEST_ASSERT_TRUE(v.assign(3, v[2]));
+    TEST_ASSERT_EQUAL_UINT32(3, v.size());
+    TEST_ASSERT_EQUAL(4, v[0]);
+    TEST_ASSERT_EQUAL(4, v[2]);
+
+    // A failed assign leaves the contents untouched.
+    TEST_ASSERT_FALSE(v.assign(SIZE_MAX / sizeof(int) + 1, 9));
+    TEST_ASSERT_EQUAL_UINT32(3, v.size());
+    TEST_ASSERT_EQUAL(4, v[1]);
+}
+
+TEST_CASE("lightstd vector bulk operations on non-trivial elements", "lightstd vector")
+{
+    vector<vector<int>> v;
+
+    for (int i = 0; i < 4; i++) {
+        vector<int> inner;
+
+        TEST_ASSERT_TRUE(inner.push_back(i));
+        TEST_ASSERT_TRUE(v.push_back(std::move(inner)));
+    }
+
+    v.erase(v.begin() + 1, v.begin() + 3);
+    TEST_ASSERT_EQUAL_UINT32(2, v.size());
+    TEST_ASSERT_EQUAL(0, v[0][0]);
+    TEST_ASSERT_EQUAL(3, v[1][0]);
+}
+
+TEST_CASE("lightstd vector growth policies", "lightstd vector")
+{
+    vector<int> doubling;
+    vector<int, growth_policy_one_and_half<4>> oneAndHalf;
+    vector<int, growth_policy_exact> exact;
+
+    for (int i = 0; i < 17; i++) {
+        TEST_ASSERT_TRUE(doubling.push_back(i));
+        TEST_ASSERT_TRUE(oneAndHalf.push_back(i));
+        TEST_ASSERT_TRUE(exact.push_back(i));
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(32, doubling.capacity());
+    TEST_ASSERT_EQUAL_UINT32(19, oneAndHalf.capacity()); // 4 -> 6 -> 9 -> 13 -> 19
+    TEST_ASSERT_EQUAL_UINT32(17, exact.capacity());
+    TEST_ASSERT_EQUAL(16, exact[16]);
+}
+
+TEST_CASE("lightstd vector resize_uninitialized", "lightstd vector")
+{
+    vector<uint8_t> v;
+
+    TEST_ASSERT_TRUE(v.resize(4, 0xAA));
+    TEST_ASSERT_TRUE(v.resize_uninitialized(64));
+    TEST_ASSERT_EQUAL_UINT32(64, v.size());
+    TEST_ASSERT_EQUAL_UINT8(0xAA, v[3]);
+
+    memset(v.data() + 4, 0x55, 60);
+    TEST_ASSERT_EQUAL_UINT8(0x55, v[63]);
+
+    TEST_ASSERT_TRUE(v.resize_uninitialized(8));
+    TEST_ASSERT_EQUAL_UINT32(8, v.size());
+}
+
+TEST_CASE("lightstd vector bulk append benchmark", "lightstd vector benchmark")
+{
+    constexpr size_t kBufferLen = 1024;
+    constexpr uint32_t kIterations = 2000;
+    static uint8_t buffer[kBufferLen];
+
+    for (size_t i = 0; i < kBufferLen; i++) {
+        buffer[i] = (uint8_t)i;
+    }
+
+    benchmarkRun("vector<uint8_t> push_back x1024", kIterations, [&](uint32_t) {
+        vector<uint8_t> v;
+
+        for (size_t i = 0; i < kBufferLen; i++) {
+            if (!v.push_back(buffer[i])) {
+                TEST_FAIL();
+            }
+        }
+        benchmarkKeep(v.data());
+    });
+
+    benchmarkRun("vector<uint8_t> append(1024)", kIterations, [&](uint32_t) {
+        vector<uint8_t> v;
+
+        if (!v.append(buffer, kBufferLen)) {
+            TEST_FAIL();
+        }
+        benchmarkKeep(v.data());
+    });
+}